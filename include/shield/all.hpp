@@ -21,10 +21,13 @@
 
 #pragma once
 
-#include <shield/exceptions.hpp>
+#include <shield/core.hpp>
+
+// The integrations are only included when their library is linked, as shield::asio and shield::folly define these
+#if defined(SHIELD_WITH_FOLLY)
 #include <shield/bulkhead.hpp>
-#include <shield/circuit.hpp>
-#include <shield/circuitbreaker.hpp>
-#include <shield/fallback.hpp>
-#include <shield/retry.hpp>
-#include <shield/timeout.hpp>
\ No newline at end of file
+#endif
+
+#if defined(SHIELD_WITH_ASIO)
+#include <shield/timeoutexecutor.hpp>
+#endif
\ No newline at end of file
@@ -21,19 +21,94 @@
 
 #pragma once
 
+#include <shield/clock.hpp>
+#include <shield/deadline.hpp>
+#include <shield/exceptions.hpp>
+#include <shield/executormetrics.hpp>
+#include <shield/probes.hpp>
+
 #include <folly/executors/ThreadedExecutor.h>
 #include <folly/futures/Future.h>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 namespace shield
 {
+// Limits the load placed on a dependency. Capacity is counted in cost units: a call takes as many units as
+// it declares (one by default), so a batch of a thousand items can be made to weigh more than a single item.
+//
+// Units are granted first come, first served. While a blocking acquire() is queued, non-blocking requests are
+// refused even if they would fit, so a stream of small requests cannot starve a large one.
 class bulkhead
 {
 public:
-    explicit bulkhead(size_t max_concurrent = 10)
+    // Units held until released or destroyed. Empty (false) when the units could not be acquired.
+    class permit final
+    {
+    public:
+        permit() = default;
+        permit(permit&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr))
+            , cost_(std::exchange(other.cost_, 0))
+        {
+        }
+
+        permit& operator=(permit&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                owner_ = std::exchange(other.owner_, nullptr);
+                cost_ = std::exchange(other.cost_, 0);
+            }
+            return *this;
+        }
+
+        ~permit()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (owner_)
+            {
+                std::exchange(owner_, nullptr)->release(cost_);
+                cost_ = 0;
+            }
+        }
+
+        size_t get_cost() const { return cost_; }
+        explicit operator bool() const { return owner_ != nullptr; }
+
+    private:
+        friend class bulkhead;
+
+        permit(bulkhead* owner, size_t cost)
+            : owner_(owner)
+            , cost_(cost)
+        {
+        }
+
+        bulkhead* owner_ = nullptr;
+        size_t cost_ = 0;
+    };
+
+    // A named bulkhead is included in the prometheus export, see executor_metrics
+    explicit bulkhead(size_t max_concurrent = 10, const std::string& name = std::string())
         : max_concurrent_(max_concurrent)
         , current_count_(0)
+        , waiting_(0)
+        , metrics_(std::make_unique<executor_metrics>(name, max_concurrent))
         , executor_(std::make_unique<folly::ThreadedExecutor>())
     {
     }
@@ -41,44 +116,96 @@ public:
     template<typename Func>
     folly::Future<typename std::invoke_result<Func()>::type> execute(Func&& func)
     {
-        if (current_count_ >= max_concurrent_)
+        return execute(1, std::forward<Func>(func));
+    }
+
+    // Runs func while holding cost units, or fails immediately if they are not available. A call cancelled
+    // before func starts gives its units back and fails with cancelled_exception instead.
+    template<typename Func>
+    folly::Future<typename std::invoke_result<Func()>::type> execute(size_t cost, Func&& func)
+    {
+        permit granted = try_acquire(cost);
+        if (!granted)
         {
             return folly::makeFuture<typename std::invoke_result<Func()>::type>(
                 std::runtime_error("Bulkhead capacity exceeded"));
         }
 
-        current_count_++;
+        const monotonic_clock::time_point submitted = monotonic_clock::precise_now();
 
         return folly::via(executor_.get())
-            .thenValue([this, f = std::forward<Func>(func)](auto&&) mutable
+            .thenValue([this, submitted, cancellation = call_context::cancellation_token(), held = std::move(granted), f = std::forward<Func>(func)](auto&&) mutable
                 {
+                    if (cancellation.stop_requested())
+                    {
+                        held.release();
+                        reject(executor_metrics::rejection_reason::cancelled);
+                        throw shield::cancelled_exception();
+                    }
+
+                    const monotonic_clock::time_point started = monotonic_clock::precise_now();
+                    metrics_->record_start(started - submitted);
                     try
                     {
                         auto result = f();
-                        current_count_--;
+                        metrics_->record_finish(monotonic_clock::precise_now() - started);
+                        held.release();
                         return result;
                     }
                     catch (...)
                     {
-                        current_count_--;
+                        metrics_->record_finish(monotonic_clock::precise_now() - started);
+                        held.release();
                         throw;
                     }
                 });
     }
 
+    // Takes cost units if they are free right now and nobody is queued for them
+    permit try_acquire(size_t cost = 1);
+
+    // Waits, in arrival order, up to timeout for cost units, giving up early if the call is cancelled (see
+    // cancellation_scope). A cost above the capacity can never be granted.
+    permit acquire(size_t cost, std::chrono::milliseconds timeout);
+
+    // Units currently held
     size_t get_current_count() const
     {
         return current_count_.load();
     }
 
+    // Capacity, in units
     size_t get_max_concurrent() const
     {
         return max_concurrent_;
     }
 
+    // Callers blocked in acquire()
+    size_t get_waiting_count() const
+    {
+        return waiting_.load();
+    }
+
+    const executor_metrics& get_metrics() const
+    {
+        return *metrics_;
+    }
+
+private:
+    struct waiter;
+
+    bool try_take(size_t cost);
+    void release(size_t cost);
+    void reject(executor_metrics::rejection_reason reason);
+    void wake_front();
+
 private:
     size_t max_concurrent_;
     std::atomic<size_t> current_count_;
+    std::atomic<size_t> waiting_;
+    std::mutex queue_mutex_;
+    std::deque<waiter*> queue_; // Blocked acquire() calls, oldest first
+    std::unique_ptr<executor_metrics> metrics_; // Declared before the executor so it outlives running tasks
     std::unique_ptr<folly::ThreadedExecutor> executor_;
 };
 }
\ No newline at end of file
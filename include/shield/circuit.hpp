@@ -22,70 +22,170 @@
 #pragma once
 
 #include <shield/circuitbreaker.hpp>
+#include <shield/clock.hpp>
+#include <shield/deadline.hpp>
 #include <shield/exceptions.hpp>
 #include <shield/fallback.hpp>
 #include <shield/retry.hpp>
 #include <shield/timeout.hpp>
 
-#include <itlib/sentry.hpp>
-
 #include <chrono>
-#include <iostream>
-#include <mutex>
-#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 
 namespace shield
 {
+namespace detail
+{
+// Calls func when the scope ends, however it ends
+template<typename Func>
+class scope_exit final
+{
+public:
+    explicit scope_exit(Func&& func)
+        : func(std::move(func))
+    {
+    }
+
+    ~scope_exit()
+    {
+        func();
+    }
+
+    scope_exit(const scope_exit&) = delete;
+    scope_exit& operator=(const scope_exit&) = delete;
+
+private:
+    Func func;
+};
+
+// The breaker a call site last resolved by name, kept until the registry changes (see state_epoch), so the
+// static circuit::run overloads look a name up once rather than on every call
+class callsite_breaker final
+{
+public:
+    const std::shared_ptr<shield::circuit_breaker>& resolve(const std::string& name);
+
+private:
+    std::string name;
+    std::shared_ptr<shield::circuit_breaker> breaker;
+    std::uint64_t epoch = 0;
+};
+} // detail
+
 class circuit final
 {
 public:
     circuit(const std::string& name, std::optional<retry_policy> retry = std::nullopt, std::optional<timeout_policy> timeout = std::nullopt, std::optional<fallback_policy> fallback = std::nullopt);
     circuit(std::shared_ptr<circuit_breaker> breaker);
 
+    // Policies are immutable once given to a circuit, so circuits (and copies of them) can share one instance.
+    // Sharing is by pointer only: equal policies built separately are not merged, as they hold predicates,
+    // callbacks and backoff strategies that cannot be compared. Build a policy once and pass it to every
+    // circuit that should share it.
+    circuit(const std::string& name, std::shared_ptr<const retry_policy> retry, std::shared_ptr<const fallback_policy> fallback = nullptr);
+
+    // A circuit over a breaker that stays registered for the life of the process, even across a registry
+    // clear, so outcomes are reported to it directly instead of looking it up by name. See static_breaker.
+    static circuit pinned(const circuit_breaker::config& cfg);
+
+    // As above for the breaker of an existing circuit, keeping its policies and key
+    static circuit pinned(circuit unpinned);
+
     circuit& with_retry_policy(const retry_policy& policy);
+    circuit& with_retry_policy(std::shared_ptr<const retry_policy> policy);
     circuit& with_fallback_policy(const fallback_policy& policy);
+    circuit& with_fallback_policy(std::shared_ptr<const fallback_policy> policy);
 
+    // Attributes this circuit's outcomes to a key (a tenant, an endpoint, a shard...) for the breaker's top-K
+    // key tracking, see circuit_breaker::config::topKeys
+    circuit& with_key(std::string key);
+
+    // Once the call is cancelled (see cancellation_scope) this throws cancelled_exception, whatever func threw,
+    // without retrying or computing a fallback, and the breaker counts a cancellation instead of a failure
     template<class _Texcept = shield::unused_exception, class Func>
     auto run(Func&& func) const
     {
         using Ret = std::invoke_result_t<Func>;
 
-        if (retryPolicy)
+        try
         {
-            if constexpr (std::is_void_v<Ret>)
+            if (retryPolicy)
             {
-                run_with_retry_policy<_Texcept>(std::forward<Func>(func));
+                if constexpr (std::is_void_v<Ret>)
+                {
+                    run_with_retry_policy<_Texcept>(std::forward<Func>(func));
+                }
+                else
+                {
+                    return run_with_retry_policy<_Texcept>(std::forward<Func>(func));
+                }
             }
             else
             {
-                return run_with_retry_policy<_Texcept>(std::forward<Func>(func));
+                if constexpr (std::is_void_v<Ret>)
+                {
+                    run_without_retry_policy<_Texcept>(std::forward<Func>(func));
+                }
+                else
+                {
+                    return run_without_retry_policy<_Texcept>(std::forward<Func>(func));
+                }
             }
         }
-        else
+        catch (...)
         {
-            if constexpr (std::is_void_v<Ret>)
+            if (!call_context::cancelled())
             {
-                run_without_retry_policy<_Texcept>(std::forward<Func>(func));
-            }
-            else
-            {
-                return run_without_retry_policy<_Texcept>(std::forward<Func>(func));
+                throw;
             }
+            on_failure(&typeid(shield::cancelled_exception));
+            throw shield::cancelled_exception();
         }
     }
 
+    // Runs with the shared default policies. The breaker is resolved once per call site (each lambda is its
+    // own instantiation) and thread, and again only when the registry changes.
+    template<class _Texcept = shield::unused_exception, class Func>
+    static auto run(Func&& func, const std::string& name)
+    {
+        thread_local detail::callsite_breaker breaker;
+        const circuit cir(breaker.resolve(name), retry_policy::shared_default(), fallback_policy::shared_default());
+        return cir.run<_Texcept>(std::forward<Func>(func));
+    }
+
+    // As above with the given policies, which are borrowed for the call rather than copied into the circuit
     template<class _Texcept = shield::unused_exception, class Func>
-    static auto run(Func&& func, const std::string& name, retry_policy retry = default_retry_policy, timeout_policy timeout = default_timeout_policy, fallback_policy fallback = default_fallback_policy)
+    static auto run(Func&& func, const std::string& name, retry_policy retry, timeout_policy timeout = default_timeout_policy, fallback_policy fallback = default_fallback_policy)
     {
-        circuit cir(name, retry, timeout, fallback);
+        thread_local detail::callsite_breaker breaker;
+        const circuit cir(breaker.resolve(name), borrow(retry), borrow(fallback));
         return cir.run<_Texcept>(std::forward<Func>(func));
     }
 
+    const std::shared_ptr<circuit_breaker>& get_circuit_breaker() const { return circuitBreaker; }
     const retry_policy& get_retry_policy() const;
     const timeout_policy& get_timeout_policy() const;
     const fallback_policy& get_fallback_policy() const;
 
 private:
+    circuit(std::shared_ptr<circuit_breaker> breaker, std::shared_ptr<const retry_policy> retry, std::shared_ptr<const fallback_policy> fallback);
+
+    static circuit pin(circuit result, const circuit_breaker::config& cfg);
+
+    // Shares nothing and allocates nothing, so policy must outlive every circuit holding the result
+    template<typename Policy>
+    static std::shared_ptr<const Policy> borrow(const Policy& policy)
+    {
+        return std::shared_ptr<const Policy>(std::shared_ptr<const Policy>(), &policy);
+    }
+
     template<class _Texcept = shield::unused_exception, class Func>
     auto run_with_retry_policy(Func&& func) const
     {
@@ -96,14 +196,14 @@ private:
             retryPolicy->run([this, &func]()
             {
                 run_without_retry_policy<_Texcept, true>(std::forward<Func>(func));
-            });
+            }, [this](const std::exception&, int, std::chrono::milliseconds delay) { on_retry(delay); }, fallbackPolicy.get(), [this]() { return next_admission(); });
         }
         else
         {
             return retryPolicy->run([this, &func]() -> Ret
             {
                 return run_without_retry_policy<_Texcept, true>(std::forward<Func>(func));
-            });
+            }, [this](const std::exception&, int, std::chrono::milliseconds delay) { on_retry(delay); }, fallbackPolicy.get(), [this]() { return next_admission(); });
         }
     }
 
@@ -112,8 +212,19 @@ private:
     {
         using Ret = std::invoke_result_t<Func>;
 
+        if (call_context::expired())
+        {
+            throw shield::deadline_exceeded_exception();
+        }
+        if (call_context::cancelled())
+        {
+            throw shield::cancelled_exception();
+        }
+
         bool succeeded = false;
-        itlib::sentry on_exit_function([&]() { handle_function_exit(succeeded); });
+        std::optional<std::chrono::nanoseconds> latency;
+        const std::type_info* failureType = nullptr;
+        detail::scope_exit on_exit_function([&]() { handle_function_exit(succeeded, latency, failureType); });
 
         // Check circuit breaker state and throw if open
         if (!on_execute_function())
@@ -142,7 +253,9 @@ private:
         {
             try
             {
-                func();
+                const auto started = monotonic_clock::precise_now();
+                invoke_capturing_failure(func, failureType);
+                latency = monotonic_clock::precise_now() - started;
                 succeeded = true;
             }
             catch (const _Texcept&)
@@ -153,6 +266,10 @@ private:
                 {
                     throw;
                 }
+                else if (call_context::cancelled())
+                {
+                    throw;
+                }
 
                 if (fallbackPolicy)
                 {
@@ -164,19 +281,25 @@ private:
         {
             try
             {
-                Ret result = func();
+                const auto started = monotonic_clock::precise_now();
+                Ret result = invoke_capturing_failure(func, failureType);
+                latency = monotonic_clock::precise_now() - started;
                 succeeded = true;
                 return result;
             }
             catch (const _Texcept& ex)
             {
-                std::cerr << ex.what() << std::endl;
+                std::fprintf(stderr, "%s\n", ex.what());
                 succeeded = false;
 
                 if constexpr (_AlwaysRethrowExceptions)
                 {
                     throw;
                 }
+                else if (call_context::cancelled())
+                {
+                    throw;
+                }
                 else if (fallbackPolicy)
                 {
                     std::optional<Ret> optionalVal = fallbackPolicy->get_value<Ret>();
@@ -199,14 +322,43 @@ private:
         }
     }
 
-    void on_success() const;
-    void on_failure() const;
+    // Records the dynamic type of any std::exception escaping func for the breaker's flight recorder
+    template<class Func>
+    static decltype(auto) invoke_capturing_failure(Func& func, const std::type_info*& failureType)
+    {
+        try
+        {
+            return func();
+        }
+        catch (const std::exception& ex)
+        {
+            failureType = &typeid(ex);
+            throw;
+        }
+    }
+
+    void on_success(std::optional<std::chrono::nanoseconds> latency) const;
+    void on_failure(const std::type_info* failureType) const;
     bool on_execute_function() const;
-    void handle_function_exit(bool success) const;
+    void on_retry(std::chrono::milliseconds delay) const;
+    std::optional<monotonic_clock::time_point> next_admission() const;
+    void handle_function_exit(bool success, std::optional<std::chrono::nanoseconds> latency, const std::type_info* failureType) const;
 
 private:
     std::shared_ptr<circuit_breaker> circuitBreaker;
-    std::optional<retry_policy> retryPolicy;
-    std::optional<fallback_policy> fallbackPolicy;
+    std::shared_ptr<const retry_policy> retryPolicy;
+    std::shared_ptr<const fallback_policy> fallbackPolicy;
+    std::string key;
+    const void* pinnedRegistration = nullptr; // Set by pinned()
 };
-} // shield
\ No newline at end of file
+} // shield
+
+// A circuit built on first use and reused by every later call through the same call site, which makes the
+// convenience form as cheap as holding a circuit yourself:
+//
+//     return SHIELD_CIRCUIT("payments", shield::retry_policy(3)).run([&]() { return client.charge(order); });
+//
+// The arguments are evaluated once, on the first call, so they cannot refer to the caller's locals. The
+// breaker is pinned (see circuit::pinned), so it survives a registry clear and is never looked up by name.
+#define SHIELD_CIRCUIT(...) \
+    ([]() -> const ::shield::circuit& { static const ::shield::circuit shield_callsite_circuit = ::shield::circuit::pinned(::shield::circuit(__VA_ARGS__)); return shield_callsite_circuit; }())
@@ -23,21 +23,29 @@
 
 //#include <shield/all.hpp>
 
-#include <shield/exceptions.hpp>
-#include <shield/fallback.hpp>
-#include <shield/retry.hpp>
-#include <shield/timeout.hpp>
+#include <shield/clock.hpp>
+#include <shield/function.hpp>
+#include <shield/timerservice.hpp>
 
 #include <chrono>
-#include <iostream>
-#include <mutex>
-#include <unordered_map>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 namespace shield
 {
 namespace detail
 {
     class circuit_breaker;
+    class circuit_breaker_manager;
+    class event_ring;
+    struct stats_slot;
 }
 
 class circuit_breaker final
@@ -49,12 +57,81 @@ public:
             : failureThreshold(5)
             , timeout(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(60)))
             , name("default")
+            , windowDuration(std::chrono::seconds(10))
+            , windowBuckets(10)
+            , latencyThreshold(std::chrono::milliseconds::zero())
+            , latencyPercentile(0.99)
+            , minimumCalls(20)
+            , adaptiveThreshold(false)
+            , adaptiveDeviation(3.0)
+            , baselineSmoothing(0.05)
+            , baselineFloor(0.001)
+            , successSampleRate(1)
+            , flightRecorderEvents(2048)
+            , flightRecorderSuccesses(false)
+            , topKeys(0)
+            , keySampleRate(1)
         {
         }
 
         int failureThreshold;
         std::chrono::milliseconds timeout;
         std::string name;
+
+        // Rolling window used by the windowed tripping modes, split into windowBuckets time buckets
+        std::chrono::milliseconds windowDuration;
+        int windowBuckets;
+
+        // Opens the breaker when the latencyPercentile (0.0 - 1.0) of successful calls in the window exceeds
+        // latencyThreshold. Zero disables latency tripping. Evaluated each time the window rotates a bucket,
+        // and only once at least minimumCalls latencies have been recorded in the window.
+        std::chrono::milliseconds latencyThreshold;
+        double latencyPercentile;
+        int minimumCalls;
+
+        // Learns the breaker's normal error rate instead of relying on failureThreshold consecutive failures.
+        // The baseline is an EWMA (weight baselineSmoothing per window bucket) of the window's error rate, and
+        // the breaker opens when the window's error rate is more than adaptiveDeviation standard deviations
+        // above it with at least failureThreshold failures in the window. baselineFloor is the lowest error
+        // rate assumed, so a dependency that never fails is not tripped by a single error. Until the first
+        // window of minimumCalls calls has been observed the consecutive failure threshold applies.
+        bool adaptiveThreshold;
+        double adaptiveDeviation;
+        double baselineSmoothing;
+        double baselineFloor;
+
+        // Records only about one in successSampleRate successes into the window, each weighted by the rate.
+        // Failures are always recorded. Intended for very hot circuits where per-call accounting is measurable.
+        int successSampleRate;
+
+        // Number of recent events (rounded up to a power of two) kept for flight_recorder dumps, zero disables.
+        // Kept per recording stripe, so a breaker called from many threads holds up to one ring per CPU.
+        int flightRecorderEvents;
+
+        // Also records successful calls in the flight recorder. Off by default, as successes are the bulk of a
+        // healthy breaker's calls and would push out the failures and transitions a dump is read for.
+        bool flightRecorderSuccesses;
+
+        // For calls made with circuit::with_key, tracks (approximately, in bounded memory) the topKeys keys with
+        // the most failures and the most total latency. Zero disables key tracking. Only about one in
+        // keySampleRate keyed outcomes is recorded, weighted by the rate.
+        int topKeys;
+        int keySampleRate;
+    };
+
+    // A tracked key's weight (failures, or latency in microseconds), overestimated by at most error
+    struct key_stats
+    {
+        std::string key;
+        std::uint64_t value;
+        std::uint64_t error;
+    };
+
+    // Latencies of a batch of successful calls, see record_outcomes
+    struct latency_summary
+    {
+        std::chrono::nanoseconds typical{}; // Representative of the calls that were not slow, such as their mean
+        std::chrono::nanoseconds slowest{};
     };
 
     enum class state
@@ -64,6 +141,44 @@ public:
         half_open
     };
 
+    // Admission to a single call, for callers that run the call themselves (an event loop, a coroutine...)
+    // instead of through circuit::run. An admitted permit is completed once, from any thread, with success()
+    // or failure(); a permit dropped without either records nothing. cancel() counts a cancellation instead,
+    // which never counts against the breaker. The breaker must outlive its permits.
+    class permit final
+    {
+    public:
+        permit() = default;
+        permit(permit&& other) noexcept
+            : breaker(std::exchange(other.breaker, nullptr))
+        {
+        }
+
+        permit& operator=(permit&& other) noexcept
+        {
+            breaker = std::exchange(other.breaker, nullptr);
+            return *this;
+        }
+
+        void success(std::optional<std::chrono::nanoseconds> latency = std::nullopt);
+        void failure(const std::type_info* exceptionType = nullptr);
+        void failure(const std::exception& ex) { failure(&typeid(ex)); }
+        void cancel();
+
+        // False when the breaker refused the call, or once the permit has been completed
+        explicit operator bool() const { return breaker != nullptr; }
+
+    private:
+        friend class circuit_breaker;
+
+        explicit permit(circuit_breaker* breaker)
+            : breaker(breaker)
+        {
+        }
+
+        circuit_breaker* breaker = nullptr; // Completed straight on the breaker, without the registry
+    };
+
     template<typename Rep, typename Period>
     static std::shared_ptr<circuit_breaker> create(const std::string& name, int failureThreshold = 5, std::chrono::duration<Rep, Period> duration = std::chrono::seconds(60))
     {
@@ -75,11 +190,39 @@ public:
     
     ~circuit_breaker();
 
-    void init(std::function<void(const std::string&, std::function<void()>, std::function<void()>, std::function<bool()>)> callback);
+    void init(unique_function<void(const std::string&, unique_function<bool()>, std::shared_ptr<detail::event_ring>, unique_function<void(detail::stats_slot*)>)> callback);
+
+    // Asks to make one call, without blocking. Check the permit before making the call.
+    //
+    // The permit holds a plain pointer to this breaker, so every admitted permit must be completed or dropped
+    // before the breaker is destroyed. Keep the shared_ptr returned by create() (or the registry entry) alive
+    // until then; completing a permit after its breaker has gone is undefined behaviour.
+    permit try_acquire();
+
+    // Reports outcomes an event loop has aggregated itself (per tick, say) as one update, so accounting costs
+    // one update per batch rather than per call. slow_calls counts the successes slower than
+    // config::latencyThreshold: the latency window records them at latency.slowest and the other successes at
+    // latency.typical. State transitions are evaluated once for the batch.
+    void record_outcomes(std::uint64_t successes, std::uint64_t failures, std::uint64_t slow_calls = 0, std::optional<latency_summary> latency = std::nullopt);
 
     state get_state() const;
+
+    // When an open breaker will let the next trial call through, nullopt unless open
+    std::optional<monotonic_clock::time_point> get_next_half_open_time() const;
+
+    // Runs func from the timer service's loop once the breaker would admit a trial call (on the next
+    // process_expired() when it is not open), so an event loop can probe it with try_acquire() without polling
+    timer_service::timer_id when_half_open(timer_service& timers, timer_service::callback func) const;
     int get_failure_count() const;
 
+    // Calls abandoned by their caller (see cancellation_scope), which are neither successes nor failures
+    std::uint64_t get_cancellation_count() const;
+    std::optional<double> get_baseline_error_rate() const;
+
+    // Heaviest keys first; empty unless config::topKeys is set
+    std::vector<key_stats> get_top_failure_keys() const;
+    std::vector<key_stats> get_top_latency_keys() const;
+
     const std::string& get_name() const;
 
 private:
@@ -87,8 +230,10 @@ private:
     circuit_breaker(const config& cfg);
 
 private:
-    void on_success();
-    void on_failure();
+    friend class detail::circuit_breaker_manager;
+
+    void on_success(std::optional<std::chrono::nanoseconds> latency = std::nullopt, std::string_view key = {});
+    void on_failure(const std::type_info* exceptionType = nullptr, std::string_view key = {});
     bool on_execute_function();
 
     std::unique_ptr<detail::circuit_breaker> pImpl;
@@ -0,0 +1,103 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace shield
+{
+// Clock used for every timestamp shield takes (breaker timers, rolling windows, deadlines). The source can be
+// switched at runtime; reading it is one relaxed load plus, depending on the source, either nothing more
+// (ticker, manual), a vDSO coarse clock read (coarse) or a steady_clock read (precise). Durations that need
+// better than millisecond resolution, such as call latencies, are timed with precise_now().
+class monotonic_clock final
+{
+public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<monotonic_clock>;
+
+    static constexpr bool is_steady = true;
+
+    enum class source
+    {
+        coarse,  ///< CLOCK_MONOTONIC_COARSE where available (millisecond resolution), otherwise the ticker
+        precise, ///< std::chrono::steady_clock on every read
+        ticker,  ///< Timestamp published every millisecond by a background thread, read with a relaxed load
+        manual,  ///< Only moves through set_time() and advance(), for tests and simulations
+    };
+
+    static time_point now() noexcept
+    {
+        switch (currentSource.load(std::memory_order_relaxed))
+        {
+        case source::precise:
+            return from_steady(std::chrono::steady_clock::now());
+#if defined(CLOCK_MONOTONIC_COARSE)
+        case source::coarse:
+        {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return time_point(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+        }
+#endif
+        default:
+            return time_point(duration(publishedTime.load(std::memory_order_relaxed)));
+        }
+    }
+
+    // steady_clock whatever the source, except that the manual source is followed so simulated time stays
+    // consistent. On the same timeline as now(), which may lag it by up to one coarse clock tick.
+    static time_point precise_now() noexcept
+    {
+        if (currentSource.load(std::memory_order_relaxed) == source::manual)
+        {
+            return time_point(duration(publishedTime.load(std::memory_order_relaxed)));
+        }
+        return from_steady(std::chrono::steady_clock::now());
+    }
+
+    static time_point from_steady(std::chrono::steady_clock::time_point tp) noexcept
+    {
+        return time_point(std::chrono::duration_cast<duration>(tp.time_since_epoch()));
+    }
+
+    // Switching to manual freezes the clock at the current time; switching to ticker starts its thread
+    static void set_source(source newSource);
+    static source get_source() noexcept { return currentSource.load(std::memory_order_relaxed); }
+
+    // Manual source only
+    static void set_time(time_point tp) noexcept;
+    static void advance(duration delta) noexcept;
+
+private:
+    static std::atomic<source> currentSource;
+    alignas(64) static std::atomic<rep> publishedTime;
+};
+} // shield
@@ -0,0 +1,40 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+// Everything in shield::core, which needs nothing beyond the standard library
+#include <shield/exceptions.hpp>
+#include <shield/circuit.hpp>
+#include <shield/circuitbreaker.hpp>
+#include <shield/clock.hpp>
+#include <shield/deadline.hpp>
+#include <shield/deadlineexecutor.hpp>
+#include <shield/executormetrics.hpp>
+#include <shield/fallback.hpp>
+#include <shield/flightrecorder.hpp>
+#include <shield/function.hpp>
+#include <shield/retry.hpp>
+#include <shield/staticbreaker.hpp>
+#include <shield/stats.hpp>
+#include <shield/timeout.hpp>
+#include <shield/timerservice.hpp>
@@ -0,0 +1,275 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <shield/clock.hpp>
+#include <shield/exceptions.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace shield
+{
+// State carried implicitly from the edge of a request to every shield stage running beneath it on the same
+// thread. Stages look it up with a single thread-local read, so code in between does not have to pass it on.
+class call_context final
+{
+public:
+    // Nested circuits, retries and timeouts never run past this point
+    std::optional<monotonic_clock::time_point> deadline;
+
+    // Where stages allocate state that lives no longer than the call, null for the default resource
+    std::pmr::memory_resource* resource = nullptr;
+
+    // Requested once the caller has abandoned the call; stages then stop spending anything more on it
+    std::stop_token cancellation;
+
+    // Innermost context installed on this thread, null when there is none
+    static const call_context* current() { return active; }
+
+    // A copy of the current context, to be re-installed elsewhere with deadline_scope
+    static call_context capture() { return active ? *active : call_context(); }
+
+    static bool expired()
+    {
+        const call_context* context = active;
+        return context && context->deadline && monotonic_clock::now() >= *context->deadline;
+    }
+
+    static bool cancelled()
+    {
+        const call_context* context = active;
+        return context && context->cancellation.stop_requested();
+    }
+
+    static std::stop_token cancellation_token()
+    {
+        const call_context* context = active;
+        return context ? context->cancellation : std::stop_token();
+    }
+
+    // Sleeps for delay unless the call is cancelled first, returning false if it was
+    static bool sleep_for(std::chrono::milliseconds delay)
+    {
+        const std::stop_token token = cancellation_token();
+        if (!token.stop_possible())
+        {
+            std::this_thread::sleep_for(delay);
+            return true;
+        }
+
+        std::mutex mutex;
+        std::condition_variable_any wakeup;
+        std::unique_lock<std::mutex> lock(mutex);
+        return !wakeup.wait_for(lock, token, delay, []() { return false; });
+    }
+
+    // Time left before the current deadline, nullopt when there is none
+    static std::optional<monotonic_clock::duration> remaining()
+    {
+        const call_context* context = active;
+        if (!context || !context->deadline)
+        {
+            return std::nullopt;
+        }
+        return std::max(*context->deadline - monotonic_clock::now(), monotonic_clock::duration::zero());
+    }
+
+    // Shortens a stage's own timeout to what is left of the deadline
+    static std::chrono::milliseconds clamp(std::chrono::milliseconds timeout)
+    {
+        const std::optional<monotonic_clock::duration> left = remaining();
+        return left ? std::min(timeout, std::chrono::ceil<std::chrono::milliseconds>(*left)) : timeout;
+    }
+
+    static std::pmr::memory_resource* memory_resource()
+    {
+        const call_context* context = active;
+        return context && context->resource ? context->resource : std::pmr::get_default_resource();
+    }
+
+private:
+    friend class deadline_scope;
+    friend class memory_scope;
+    friend class cancellation_scope;
+
+    static inline thread_local const call_context* active = nullptr;
+};
+
+// Installs a deadline for everything called on this thread until the scope ends. A nested scope can only
+// shorten the deadline, never extend it.
+//
+// A scope must not span a coroutine suspension point, since the coroutine may resume on another thread.
+// Capture the context before suspending and re-install it after resuming, or wrap work handed to another
+// thread with deadline_scope::bind:
+//
+//     const shield::call_context context = shield::call_context::capture();
+//     co_await something();
+//     shield::deadline_scope scope(context);
+class deadline_scope final
+{
+public:
+    explicit deadline_scope(monotonic_clock::duration budget)
+        : deadline_scope(monotonic_clock::now() + budget)
+    {
+    }
+
+    explicit deadline_scope(monotonic_clock::time_point deadline)
+        : context(call_context::capture())
+        , previous(call_context::active)
+    {
+        context.deadline = context.deadline ? std::min(*context.deadline, deadline) : deadline;
+        call_context::active = &context;
+    }
+
+    // Re-installs a captured context as is
+    explicit deadline_scope(const call_context& captured)
+        : context(captured)
+        , previous(call_context::active)
+    {
+        call_context::active = &context;
+    }
+
+    ~deadline_scope()
+    {
+        call_context::active = previous;
+    }
+
+    deadline_scope(const deadline_scope&) = delete;
+    deadline_scope& operator=(const deadline_scope&) = delete;
+
+    // Returns func bound to the current context, which is re-installed wherever and whenever it is invoked
+    template<typename Func>
+    static auto bind(Func&& func)
+    {
+        return [captured = call_context::capture(), func = std::forward<Func>(func)]() mutable -> decltype(auto)
+        {
+            deadline_scope scope(captured);
+            return func();
+        };
+    }
+
+private:
+    call_context context;
+    const call_context* previous;
+};
+
+// Routes the per-call state of every stage called on this thread to resource until the scope ends, so a
+// request's resilience state can be released in one go, typically with a std::pmr::monotonic_buffer_resource:
+//
+//     std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+//     shield::memory_scope scope(arena);
+//     shield::circuit("payments").run(...);
+//
+// The resource must outlive the scope, and anything bound with deadline_scope::bind while it is installed.
+class memory_scope final
+{
+public:
+    explicit memory_scope(std::pmr::memory_resource& resource)
+        : context(call_context::capture())
+        , previous(call_context::active)
+    {
+        context.resource = &resource;
+        call_context::active = &context;
+    }
+
+    ~memory_scope()
+    {
+        call_context::active = previous;
+    }
+
+    memory_scope(const memory_scope&) = delete;
+    memory_scope& operator=(const memory_scope&) = delete;
+
+private:
+    call_context context;
+    const call_context* previous;
+};
+
+// Cancels everything called on this thread until the scope ends once token is stopped: retries stop, no
+// fallback is computed, bulkhead waiters give up their place and timed tasks are asked to stop. Cancelled calls
+// throw cancelled_exception and are counted as cancellations rather than failures.
+//
+// Nested scopes are linked, so stopping either token cancels the inner calls. The link is owned by the scope,
+// so it must outlive anything bound with deadline_scope::bind while it is installed.
+class cancellation_scope final
+{
+public:
+    explicit cancellation_scope(std::stop_token token)
+        : context(call_context::capture())
+        , previous(call_context::active)
+    {
+        if (context.cancellation.stop_possible() && token.stop_possible())
+        {
+            linked.emplace(context.cancellation, token);
+            context.cancellation = linked->source.get_token();
+        }
+        else if (token.stop_possible())
+        {
+            context.cancellation = std::move(token);
+        }
+        call_context::active = &context;
+    }
+
+    ~cancellation_scope()
+    {
+        call_context::active = previous;
+    }
+
+    cancellation_scope(const cancellation_scope&) = delete;
+    cancellation_scope& operator=(const cancellation_scope&) = delete;
+
+private:
+    struct forward_stop
+    {
+        std::stop_source* target;
+
+        void operator()() const { target->request_stop(); }
+    };
+
+    // Stopped when either of two tokens is
+    struct link
+    {
+        link(const std::stop_token& first, const std::stop_token& second)
+            : fromFirst(first, forward_stop{ &source })
+            , fromSecond(second, forward_stop{ &source })
+        {
+        }
+
+        std::stop_source source;
+        std::stop_callback<forward_stop> fromFirst;
+        std::stop_callback<forward_stop> fromSecond;
+    };
+
+    call_context context;
+    const call_context* previous;
+    std::optional<link> linked;
+};
+} // shield
@@ -0,0 +1,124 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <shield/clock.hpp>
+#include <shield/deadline.hpp>
+#include <shield/exceptions.hpp>
+#include <shield/executormetrics.hpp>
+#include <shield/function.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace shield
+{
+namespace detail
+{
+    class deadline_executor;
+}
+
+// Thread pool for shield's asynchronous work that runs the queued task with the earliest deadline first, rather
+// than in submission order, so a call with 5ms left does not wait behind one with 5s left. timeout_executor
+// runs its tasks on one, and with_timeout can be given one instead of starting a thread per call; it is opt-in
+// everywhere else. A task's deadline is that of the call context it was submitted under; tasks without one
+// run after every task with one, in submission order. A task still queued when its deadline passes, or when
+// its call is cancelled (see cancellation_scope), is dropped without running.
+//
+// The queue is a pairing heap: queuing is a single comparison, and taking the next task amortised O(log n).
+//
+// Queue nodes and the shared state behind submit()'s futures come from the executor's memory resource rather
+// than the submitting call's, as a queued task can outlive the call that submitted it.
+class deadline_executor final
+{
+public:
+    // A named executor is included in the prometheus export, see executor_metrics. The resource must outlive
+    // the executor and every future it returned.
+    explicit deadline_executor(std::size_t threads, const std::string& name = std::string(), std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Stops the threads once they finish their current task; tasks still queued are dropped
+    ~deadline_executor();
+
+    deadline_executor(const deadline_executor&) = delete;
+    deadline_executor& operator=(const deadline_executor&) = delete;
+
+    // Runs func under the caller's call context. The future holds a deadline_exceeded_exception if the task
+    // was dropped because its deadline passed while it was queued, or a cancelled_exception if its call was
+    // cancelled.
+    template<typename Func>
+    auto submit(Func&& func)
+    {
+        using return_type = std::invoke_result_t<std::decay_t<Func>&>;
+
+        std::promise<return_type> promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(get_memory_resource()));
+        std::future<return_type> future = promise.get_future();
+        enqueue(call_context::capture(), [func = std::forward<Func>(func), promise = std::move(promise)](std::exception_ptr dropped) mutable
+        {
+            if (dropped)
+            {
+                promise.set_exception(std::move(dropped));
+                return;
+            }
+
+            try
+            {
+                if constexpr (std::is_void_v<return_type>)
+                {
+                    func();
+                    promise.set_value();
+                }
+                else
+                {
+                    promise.set_value(func());
+                }
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    // As submit() without a result. A dropped task is only counted in the metrics, and anything func throws
+    // is discarded.
+    void post(unique_function<void()> func);
+
+    std::size_t get_queued_count() const;
+    const executor_metrics& get_metrics() const;
+    std::pmr::memory_resource* get_memory_resource() const;
+
+private:
+    // task(reason) is called instead of running the task when it is dropped, task(nullptr) to run it
+    void enqueue(call_context context, unique_function<void(std::exception_ptr)> task);
+
+    std::unique_ptr<detail::deadline_executor> pImpl;
+};
+} // shield
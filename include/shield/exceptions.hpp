@@ -75,4 +75,22 @@ public:
     {
     }
 };
+
+class deadline_exceeded_exception : public runtime_error
+{
+public:
+    deadline_exceeded_exception()
+        : runtime_error("The deadline of the enclosing deadline_scope has passed.")
+    {
+    }
+};
+
+class cancelled_exception : public runtime_error
+{
+public:
+    cancelled_exception()
+        : runtime_error("The call was cancelled by the enclosing cancellation_scope.")
+    {
+    }
+};
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <shield/clock.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace prometheus
+{
+class Collectable;
+}
+
+namespace shield
+{
+namespace detail
+{
+    class executor_metrics;
+}
+
+// Telemetry of a bulkhead or executor: how long tasks wait before running, how long they run, how many were
+// turned away and why, and how busy the executor was. Recording goes to one of a fixed set of per-thread
+// cells, so concurrent tasks do not contend on shared counters; reads merge the cells.
+//
+// Utilisation over an interval is the growth of executionTotal divided by capacity times the interval, see
+// utilisation(). In prometheus that is rate(shield_executor_busy_seconds_total[5m]) / shield_executor_capacity.
+class executor_metrics final
+{
+public:
+    enum class rejection_reason
+    {
+        capacity,  ///< Every slot was in use
+        timeout,   ///< The task did not finish in time
+        expired,   ///< The task was still queued when its deadline passed
+        cancelled, ///< The call was cancelled while waiting to start
+    };
+    static constexpr std::size_t rejectionReasonCount = 4;
+
+    // Cumulative count of samples at or below each upper bound (powers of two microseconds)
+    using histogram = std::vector<std::pair<std::chrono::microseconds, std::uint64_t>>;
+
+    struct snapshot
+    {
+        monotonic_clock::time_point takenAt;
+        std::uint64_t started = 0;
+        std::uint64_t finished = 0;
+        std::array<std::uint64_t, rejectionReasonCount> rejections{};
+        std::chrono::nanoseconds queueWaitTotal{ 0 };
+        std::chrono::nanoseconds executionTotal{ 0 }; ///< Busy time, summed over every task
+        histogram queueWait;
+        histogram execution;
+    };
+
+    // Executors with an empty name are measured but left out of the prometheus export
+    explicit executor_metrics(const std::string& name = std::string(), std::size_t capacity = 0);
+    ~executor_metrics();
+
+    executor_metrics(const executor_metrics&) = delete;
+    executor_metrics& operator=(const executor_metrics&) = delete;
+
+    void record_start(std::chrono::nanoseconds queueWait);
+    void record_finish(std::chrono::nanoseconds executionTime);
+    void record_rejection(rejection_reason reason);
+
+    snapshot get_snapshot() const;
+    const std::string& get_name() const;
+    std::size_t get_capacity() const;
+
+    // Fraction (0.0 - 1.0) of the capacity that was busy between two snapshots
+    static double utilisation(const snapshot& from, const snapshot& to, std::size_t capacity);
+
+    // Exports every named executor_metrics alive at scrape time, labelled by executor name. Register it once,
+    // e.g. exposer.RegisterCollectable(shield::executor_metrics::get_prometheus_collectable()). Defined by the
+    // shield::prometheus library.
+    static std::shared_ptr<prometheus::Collectable> get_prometheus_collectable();
+
+private:
+    std::unique_ptr<detail::executor_metrics> pImpl;
+};
+} // shield
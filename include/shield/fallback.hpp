@@ -22,8 +22,11 @@
 #pragma once
 
 #include <shield/exceptions.hpp>
+#include <shield/function.hpp>
+#include <shield/probes.hpp>
 
 #include <any>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -34,20 +37,32 @@
 
 namespace shield
 {
+namespace detail
+{
+    class memoised_fallback;
+}
+
 enum class fallback_type 
 {
     DEFAULT,        ///< Returns the default value for the type
     SPECIFIC_VALUE, ///< Returns a pre-configured specific value
     CALLABLE,       ///< Invokes a fallback function to compute and return a value
     THROW,          ///< Will throw an exception rather than trying to provide a value
+    MEMOISED,       ///< Returns the last value computed by a fallback function refreshed in the background
 };
 
 struct fallback_policy
 {
 public:
-    using callable_type = std::function<std::any()>;
+    using callable_type = small_function<std::any()>;
 
 public:
+    // Same as with_default(), and usable for constant initialisation
+    constexpr fallback_policy()
+        : fallbackType(fallback_type::DEFAULT)
+    {
+    }
+
     static fallback_policy with_default();
 
     template<typename T>
@@ -69,10 +84,30 @@ public:
 
     static fallback_policy with_throw();
 
+    // For fallback functions too expensive to run on every rejected call. The function is called once here and
+    // then every refresh_interval on a background thread, and get_value() only loads the latest result. A
+    // refresh that throws keeps the previous value. Copies of the policy share the value, and the thread stops
+    // with the last of them.
+    static fallback_policy with_memoised(callable_type fallback_function, std::chrono::milliseconds refresh_interval);
+
+    template<typename Callable>
+    static fallback_policy with_typed_memoised(Callable&& fallback_fn, std::chrono::milliseconds refresh_interval)
+    {
+        return with_memoised([fn = std::forward<Callable>(fallback_fn)]() -> std::any
+        {
+            return fn();
+        }, refresh_interval);
+    }
+
+    // A single process-wide with_default() policy, which circuits share instead of copying default_fallback_policy
+    static const std::shared_ptr<const fallback_policy>& shared_default();
+
     template<typename T>
     requires (!std::is_void_v<T>)
     std::optional<T> get_value() const 
     {
+        SHIELD_PROBE1(fallback_invoke, static_cast<int>(fallbackType));
+
         switch (fallbackType)
         {
         case fallback_type::THROW:
@@ -114,6 +149,13 @@ public:
                 }
                 return std::nullopt;
 
+            case fallback_type::MEMOISED:
+                if (const std::shared_ptr<const std::any> memoised = load_memoised(); memoised && memoised->type() == typeid(T))
+                {
+                    return std::any_cast<T>(*memoised);
+                }
+                return std::nullopt;
+
             default:
                 return std::nullopt;
             }
@@ -129,6 +171,8 @@ public:
     requires (std::is_void_v<T>)
     void get_value() const 
     {
+        SHIELD_PROBE1(fallback_invoke, static_cast<int>(fallbackType));
+
         switch (fallbackType) 
         {
         case fallback_type::DEFAULT:
@@ -181,6 +225,10 @@ public:
         {
             return specificValue.type() == typeid(T);
         }
+        if (fallbackType == fallback_type::MEMOISED)
+        {
+            return stored_type() == typeid(T);
+        }
         // For CALLABLE, we can't know without executing
         return true;
     }
@@ -196,10 +244,13 @@ private:
 
     void validate() const;
 
+    std::shared_ptr<const std::any> load_memoised() const;
+
 private:
     fallback_type fallbackType;
     std::any specificValue;
     callable_type fallbackCallable;
+    std::shared_ptr<detail::memoised_fallback> memoised; // Only for MEMOISED
 };
 
 /**
@@ -210,5 +261,5 @@ private:
  */
 std::string to_string(fallback_type type);
 
-static const fallback_policy default_fallback_policy = fallback_policy::with_default();
+extern const fallback_policy default_fallback_policy;
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace shield
+{
+// Always-on, fixed-size record of the most recent events of every circuit breaker, meant to be dumped when
+// an incident happens instead of running verbose logging all the time. The ring size is set per breaker
+// through circuit_breaker::config::flightRecorderEvents, and successes are only recorded when
+// circuit_breaker::config::flightRecorderSuccesses is set.
+//
+// Dump file layout (little endian):
+//   char[4]  magic "SHFR"
+//   uint32   version (1)
+//   uint64   shield clock at dump time, in milliseconds
+//   uint32   exception type count, then for each: uint32 index, uint16 length, char[length] name
+//   uint32   breaker count, then for each: uint16 length, char[length] name, uint32 event count, uint64[count] events
+// Each event is bits 63-56 type, 55-32 payload, 31-0 timestamp (milliseconds, truncated to 32 bits).
+class flight_recorder final
+{
+public:
+    enum class event_type : std::uint8_t
+    {
+        transition = 1,   ///< payload: (from state << 4) | to state
+        success = 2,      ///< payload: latency in microseconds, saturated at 2^24 - 1
+        failure = 3,      ///< payload: exception type index (0 when unknown)
+        rejection = 4,    ///< payload: unused
+        retry = 5,        ///< payload: backoff delay in milliseconds
+        cancellation = 6, ///< payload: unused
+    };
+
+    struct event
+    {
+        event_type type;
+        std::uint32_t payload;
+        std::uint32_t timestamp; ///< Milliseconds of the shield clock, truncated to 32 bits
+    };
+
+    struct dump_contents
+    {
+        std::uint64_t dumpedAt = 0;
+        std::map<std::uint32_t, std::string> exceptionTypes;
+        std::map<std::string, std::vector<event>> breakers;
+    };
+
+    static constexpr std::uint32_t fileVersion = 1;
+
+    // Write every registered breaker's events, or only the named breaker's, to a binary file
+    static bool dump(const std::string& path);
+    static bool dump(const std::string& path, const std::string& breakerName);
+
+    // Events of a registered breaker, oldest first
+    static std::vector<event> get_events(const std::string& breakerName);
+
+    static std::optional<dump_contents> read_dump(const std::string& path);
+
+    static event decode(std::uint64_t raw);
+
+    // POSIX only: dumps every breaker to <directory>/shield-flight-<pid>-<n>.bin whenever the signal arrives.
+    // The handler only writes to a pipe; the dump itself runs on a background thread.
+    static bool install_signal_handler(int signal, const std::string& directory);
+};
+} // shield
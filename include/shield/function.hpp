@@ -0,0 +1,289 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace shield
+{
+// Enough for a lambda capturing a few references, or a shared_ptr and a pointer
+inline constexpr std::size_t default_function_capacity = 4 * sizeof(void*);
+
+namespace detail
+{
+template<typename Signature, std::size_t Capacity, bool Copyable>
+class basic_function;
+
+template<typename T>
+struct is_std_function : std::false_type {};
+
+template<typename Signature>
+struct is_std_function<std::function<Signature>> : std::true_type {};
+
+// Type-erased callable stored in place when it fits in Capacity bytes (and moves without throwing), and on
+// the heap otherwise. Use small_function or unique_function rather than naming this directly.
+template<typename R, typename... Args, std::size_t Capacity, bool Copyable>
+class basic_function<R(Args...), Capacity, Copyable> final
+{
+public:
+    // Whether a callable of type F avoids the heap
+    template<typename F>
+    static constexpr bool stores_inline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    constexpr basic_function() noexcept = default;
+    constexpr basic_function(std::nullptr_t) noexcept {}
+
+    template<typename F>
+    requires (!std::is_same_v<std::decay_t<F>, basic_function> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    basic_function(F&& func)
+    {
+        using stored_type = std::decay_t<F>;
+        static_assert(!Copyable || std::is_copy_constructible_v<stored_type>, "small_function requires a copyable callable, use unique_function");
+
+        if constexpr (std::is_pointer_v<stored_type> || std::is_member_pointer_v<stored_type> || is_std_function<stored_type>::value)
+        {
+            // Null function pointers and empty std::functions make an empty function, as they do for std::function
+            if (!static_cast<bool>(func))
+            {
+                return;
+            }
+        }
+
+        if constexpr (stores_inline<stored_type>)
+        {
+            ::new (static_cast<void*>(storage)) stored_type(std::forward<F>(func));
+        }
+        else
+        {
+            *reinterpret_cast<stored_type**>(storage) = new stored_type(std::forward<F>(func));
+        }
+        ops = &operations_for<stored_type>;
+    }
+
+    basic_function(const basic_function& other) requires Copyable
+    {
+        if (other.ops)
+        {
+            other.ops->copy(other.storage, storage);
+            ops = other.ops;
+        }
+    }
+
+    basic_function(const basic_function&) requires (!Copyable) = delete;
+
+    basic_function(basic_function&& other) noexcept
+    {
+        take(other);
+    }
+
+    ~basic_function()
+    {
+        reset();
+    }
+
+    basic_function& operator=(const basic_function& other) requires Copyable
+    {
+        if (this != &other)
+        {
+            basic_function copy(other);
+            reset();
+            take(copy);
+        }
+        return *this;
+    }
+
+    basic_function& operator=(const basic_function&) requires (!Copyable) = delete;
+
+    basic_function& operator=(basic_function&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    basic_function& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template<typename F>
+    requires (!std::is_same_v<std::decay_t<F>, basic_function> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    basic_function& operator=(F&& func)
+    {
+        return *this = basic_function(std::forward<F>(func));
+    }
+
+    // Like std::function, calling through a const function may mutate the callable
+    R operator()(Args... args) const
+    {
+        if (!ops)
+        {
+            throw std::bad_function_call();
+        }
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops != nullptr;
+    }
+
+    friend bool operator==(const basic_function& func, std::nullptr_t) noexcept
+    {
+        return !func;
+    }
+
+private:
+    using copy_operation = void(*)(const void* from, void* to);
+
+    struct operations
+    {
+        R(*invoke)(void* storage, Args&&... args);
+        copy_operation copy; // Null when move-only
+        void(*relocate)(void* from, void* to) noexcept; // Moves into to and destroys from
+        void(*destroy)(void* storage) noexcept;
+    };
+
+    template<typename F>
+    static F* target(void* storage) noexcept
+    {
+        if constexpr (stores_inline<F>)
+        {
+            return std::launder(reinterpret_cast<F*>(storage));
+        }
+        else
+        {
+            return *reinterpret_cast<F**>(storage);
+        }
+    }
+
+    template<typename F>
+    static R invoke(void* storage, Args&&... args)
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            std::invoke(*target<F>(storage), std::forward<Args>(args)...);
+        }
+        else
+        {
+            return std::invoke(*target<F>(storage), std::forward<Args>(args)...);
+        }
+    }
+
+    template<typename F>
+    static void copy(const void* from, void* to)
+    {
+        const F& source = *target<F>(const_cast<void*>(from));
+        if constexpr (stores_inline<F>)
+        {
+            ::new (to) F(source);
+        }
+        else
+        {
+            *reinterpret_cast<F**>(to) = new F(source);
+        }
+    }
+
+    template<typename F>
+    static void relocate(void* from, void* to) noexcept
+    {
+        if constexpr (stores_inline<F>)
+        {
+            F* source = target<F>(from);
+            ::new (to) F(std::move(*source));
+            source->~F();
+        }
+        else
+        {
+            *reinterpret_cast<F**>(to) = *reinterpret_cast<F**>(from);
+        }
+    }
+
+    template<typename F>
+    static void destroy(void* storage) noexcept
+    {
+        if constexpr (stores_inline<F>)
+        {
+            target<F>(storage)->~F();
+        }
+        else
+        {
+            delete target<F>(storage);
+        }
+    }
+
+    template<typename F>
+    static constexpr copy_operation copy_for()
+    {
+        if constexpr (Copyable)
+        {
+            return &copy<F>;
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    template<typename F>
+    static constexpr operations operations_for{ &invoke<F>, copy_for<F>(), &relocate<F>, &destroy<F> };
+
+    void take(basic_function& other) noexcept
+    {
+        if (other.ops)
+        {
+            other.ops->relocate(other.storage, storage);
+            ops = std::exchange(other.ops, nullptr);
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (ops)
+        {
+            std::exchange(ops, nullptr)->destroy(storage);
+        }
+    }
+
+private:
+    alignas(std::max_align_t) mutable unsigned char storage[Capacity < sizeof(void*) ? sizeof(void*) : Capacity]{}; // Zeroed so empty functions can be constant-initialised
+    const operations* ops = nullptr;
+};
+} // detail
+
+// Copyable replacement for std::function that keeps callables of up to Capacity bytes off the heap
+template<typename Signature, std::size_t Capacity = default_function_capacity>
+using small_function = detail::basic_function<Signature, Capacity, true>;
+
+// Move-only small_function, which can also hold move-only callables
+template<typename Signature, std::size_t Capacity = default_function_capacity>
+using unique_function = detail::basic_function<Signature, Capacity, false>;
+} // shield
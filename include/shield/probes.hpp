@@ -0,0 +1,53 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+// Linux USDT (sys/sdt.h) static tracepoints under the "shield" provider. They are compiled in by default and
+// cost a single nop until a tracer such as bpftrace or perf attaches, e.g.
+//   bpftrace -e 'usdt:./app:shield:breaker_transition { printf("%s %d -> %d\n", str(arg0), arg1, arg2); }'
+// Define SHIELD_DISABLE_USDT (CMake option SHIELD_ENABLE_USDT=OFF) to compile them out entirely. CMake turns
+// the option off with a warning when sys/sdt.h is missing.
+//
+// Probes:
+//   breaker_transition(const char* name, int from, int to)
+//   breaker_reject(const char* name)
+//   retry_attempt(int attempt, long long delay_ms)
+//   fallback_invoke(int fallback_type)
+//   bulkhead_reject(size_t current, size_t max)
+//   timeout_fired(long long timeout_ms)
+
+#if !defined(SHIELD_DISABLE_USDT) && defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SHIELD_HAS_USDT 1
+#endif
+#endif
+
+#if defined(SHIELD_HAS_USDT)
+#define SHIELD_PROBE1(name, a1) DTRACE_PROBE1(shield, name, a1)
+#define SHIELD_PROBE2(name, a1, a2) DTRACE_PROBE2(shield, name, a1, a2)
+#define SHIELD_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(shield, name, a1, a2, a3)
+#else
+#define SHIELD_PROBE1(name, a1) do { } while (0)
+#define SHIELD_PROBE2(name, a1, a2) do { } while (0)
+#define SHIELD_PROBE3(name, a1, a2, a3) do { } while (0)
+#endif
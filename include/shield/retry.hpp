@@ -21,12 +21,18 @@
 
 #pragma once
 
+#include <shield/deadline.hpp>
+#include <shield/fallback.hpp>
+#include <shield/function.hpp>
+#include <shield/probes.hpp>
+#include <shield/timerservice.hpp>
+
 #include <chrono>
 #include <cmath>
 #include <exception>
 #include <functional>
-#include <iostream>
 #include <memory>
+#include <optional>
 #include <random>
 #include <thread>
 #include <vector>
@@ -78,7 +84,7 @@ private:
 class exponential_backoff final : public backoff_strategy
 {
 public:
-    exponential_backoff(
+    constexpr exponential_backoff(
         std::chrono::milliseconds initial_delay,
         double multiplier = 2.0,
         std::chrono::milliseconds max_delay = std::chrono::seconds(60)
@@ -204,22 +210,22 @@ private:
 class retry_policy final
 {
 public:
-    using retry_predicate = std::function<bool(const std::exception&, int)>;
+    using retry_predicate = small_function<bool(const std::exception&, int)>;
     
     // ========================================================================
     // CONSTRUCTORS
     // ========================================================================
     
-    retry_policy()
+    // Without an explicit backoff the policy uses a shared exponential backoff starting at 100ms, so these
+    // allocate nothing and default_retry_policy is constant-initialised
+    constexpr retry_policy()
         : maxAttempts(3)
-        , backoff(std::make_unique<exponential_backoff>(std::chrono::milliseconds(100)))
         , retryOnAllExceptions(true)
     {
     }
     
-    explicit retry_policy(int max_attempts)
+    constexpr explicit retry_policy(int max_attempts)
         : maxAttempts(max_attempts)
-        , backoff(std::make_unique<exponential_backoff>(std::chrono::milliseconds(100)))
         , retryOnAllExceptions(true)
     {
     }
@@ -320,10 +326,43 @@ public:
     template<typename Func>
     auto run(Func&& func) const
     {
+        return run(std::forward<Func>(func), [](const std::exception&, int, std::chrono::milliseconds) {});
+    }
+
+    // As run(), with before_retry(exception, attempt, delay) invoked ahead of each backoff sleep. Used by
+    // components wrapping the policy (such as circuit) to observe retries without touching the user callback.
+    // A non-null fallback is used in place of the policy's own, so a shared policy never has to be copied.
+    template<typename Func, typename BeforeRetry>
+    auto run(Func&& func, BeforeRetry&& before_retry, const fallback_policy* fallback = nullptr) const
+    {
+        return run(std::forward<Func>(func), std::forward<BeforeRetry>(before_retry), fallback, []() { return std::optional<monotonic_clock::time_point>(); });
+    }
+
+    // As above, with admitted_from() giving the earliest time another attempt could be admitted (nullopt when
+    // it could be now), such as when an open circuit breaker will next let a trial call through. Attempts the
+    // backoff would schedule before then are skipped rather than slept for, and when none of the remaining
+    // attempts could be admitted, within the deadline or at all, the policy goes straight to the fallback.
+    template<typename Func, typename BeforeRetry, typename AdmittedFrom>
+    auto run(Func&& func, BeforeRetry&& before_retry, const fallback_policy* fallback, AdmittedFrom&& admitted_from) const
+    {
+        if (!fallback && fallbackPolicy)
+        {
+            fallback = &*fallbackPolicy;
+        }
+
         using Ret = std::invoke_result_t<Func>;
         
         for (int attempt = 1; attempt <= maxAttempts; ++attempt)
         {
+            if (call_context::expired())
+            {
+                throw shield::deadline_exceeded_exception();
+            }
+            if (call_context::cancelled())
+            {
+                throw shield::cancelled_exception();
+            }
+
             try
             {
                 return func();
@@ -332,22 +371,67 @@ public:
             {
                 throw;
             }
+            catch (const shield::deadline_exceeded_exception&)
+            {
+                throw;
+            }
+            catch (const shield::cancelled_exception&)
+            {
+                throw;
+            }
             catch (const std::exception& e)
             {
+                // Whatever the attempt failed with, the caller no longer wants a retry or a fallback
+                if (call_context::cancelled())
+                {
+                    throw shield::cancelled_exception();
+                }
+
                 if (!should_retry(e, attempt))
                 {
-                    return invoke_fallback(func);
+                    return invoke_fallback(func, fallback);
                 }
                 
                 if (attempt < maxAttempts)
                 {
-                    auto delay = backoff->calculate_delay(attempt);
+                    auto delay = get_backoff_strategy()->calculate_delay(attempt);
+
+                    // An attempt made before the breaker admits calls again would only be rejected
+                    int skipped = 0;
+                    if (const std::optional<monotonic_clock::time_point> admitted = admitted_from())
+                    {
+                        const monotonic_clock::time_point now = monotonic_clock::now();
+                        while (now + delay < *admitted && attempt + skipped + 1 < maxAttempts)
+                        {
+                            ++skipped;
+                            delay += get_backoff_strategy()->calculate_delay(attempt + skipped);
+                        }
+
+                        if (now + delay < *admitted)
+                        {
+                            return invoke_fallback(func, fallback);
+                        }
+                    }
+
+                    // Sleeping past the enclosing deadline would only lead to an attempt that cannot finish
+                    const std::optional<monotonic_clock::duration> left = call_context::remaining();
+                    if (left && *left <= delay)
+                    {
+                        return invoke_fallback(func, fallback);
+                    }
+
+                    attempt += skipped;
                     on_retry(e, attempt, delay);
-                    std::this_thread::sleep_for(delay);
+                    before_retry(e, attempt, delay);
+                    SHIELD_PROBE2(retry_attempt, attempt, static_cast<long long>(delay.count()));
+                    if (!call_context::sleep_for(delay))
+                    {
+                        throw shield::cancelled_exception();
+                    }
                 }
                 else
                 {
-                    return invoke_fallback(func);
+                    return invoke_fallback(func, fallback);
                 }
             }
         }
@@ -356,10 +440,34 @@ public:
         throw std::runtime_error("Retry policy exhausted");
     }
     
+    // Event loop counterpart of run(): once attempt (counting from 1) has failed with e, schedules retry() on
+    // the timer service after the backoff instead of sleeping. Returns false, scheduling nothing, when the
+    // policy would not retry: e is not retryable, the attempts are used up, the call is cancelled or the
+    // backoff would pass the deadline. The caller then falls back, unless the call is cancelled.
+    bool schedule_retry(timer_service& timers, const std::exception& e, int attempt, timer_service::callback retry) const
+    {
+        if (attempt >= maxAttempts || call_context::cancelled() || !should_retry(e, attempt))
+        {
+            return false;
+        }
+
+        const std::chrono::milliseconds delay = get_backoff_strategy()->calculate_delay(attempt);
+        const std::optional<monotonic_clock::duration> left = call_context::remaining();
+        if (left && *left <= delay)
+        {
+            return false;
+        }
+
+        on_retry(e, attempt, delay);
+        SHIELD_PROBE2(retry_attempt, attempt, static_cast<long long>(delay.count()));
+        timers.schedule_after(delay, std::move(retry));
+        return true;
+    }
+
     int get_max_attempts() const { return maxAttempts; }
-    const backoff_strategy* get_backoff_strategy() const { return backoff.get(); }
+    const backoff_strategy* get_backoff_strategy() const { return backoff ? backoff.get() : &default_backoff(); }
     
-    using retry_callback = std::function<void(const std::exception&, int, std::chrono::milliseconds)>;
+    using retry_callback = small_function<void(const std::exception&, int, std::chrono::milliseconds)>;
     
     retry_policy& on_retry(retry_callback callback)
     {
@@ -373,8 +481,17 @@ public:
     {
         fallbackPolicy = policy;
     }
+
+    // A single process-wide default policy, which circuits share instead of copying default_retry_policy
+    static const std::shared_ptr<const retry_policy>& shared_default()
+    {
+        static const std::shared_ptr<const retry_policy> instance = std::make_shared<const retry_policy>();
+        return instance;
+    }
     
 private:
+    static const backoff_strategy& default_backoff();
+
     bool should_retry(const std::exception& e, int attempt) const
     {
         // Check if we've exhausted attempts
@@ -417,20 +534,20 @@ private:
     }
 
     template<typename Func>
-    auto invoke_fallback(Func&& func) const
+    static auto invoke_fallback(Func&& func, const fallback_policy* fallback)
     {
         using Ret = std::invoke_result_t<Func>;
 
         if constexpr (std::is_void_v<Ret>)
         {
-            if (fallbackPolicy)
+            if (fallback)
             {
-                fallbackPolicy->get_value<Ret>();
+                fallback->get_value<Ret>();
             }
         }
-        else if (fallbackPolicy)
+        else if (fallback)
         {
-            auto optionalVal = fallbackPolicy->get_value<Ret>();
+            auto optionalVal = fallback->get_value<Ret>();
             if (optionalVal.has_value())
             {
                 return optionalVal.value();
@@ -442,7 +559,7 @@ private:
     
 private:
     int maxAttempts;
-    std::unique_ptr<backoff_strategy> backoff;
+    std::unique_ptr<backoff_strategy> backoff; // Null for default_backoff()
     bool retryOnAllExceptions;
     retry_predicate retryPredicate;
     std::vector<size_t> retryableExceptions;
@@ -470,5 +587,5 @@ inline retry_policy make_jittered_retry_policy(int max_attempts, std::chrono::mi
         .with_jittered_backoff(initial_delay);
 }
 
-static const retry_policy default_retry_policy;
+extern const retry_policy default_retry_policy;
 } // shield
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <shield/circuit.hpp>
+#include <shield/circuitbreaker.hpp>
+#include <shield/exceptions.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace shield
+{
+// A string literal usable as a template argument
+template<std::size_t N>
+struct fixed_string
+{
+    constexpr fixed_string(const char (&text)[N])
+    {
+        std::copy_n(text, N, value);
+    }
+
+    constexpr std::string_view view() const
+    {
+        return std::string_view(value, N - 1);
+    }
+
+    char value[N];
+};
+
+// A breaker whose name is known at compile time. It is created and pinned in the registry during static
+// initialisation, so it appears in get_event_rings(), the stats segment and flight recorder dumps like any
+// other breaker, and calls through it reach its registration directly instead of hashing the name:
+//
+//     using payments_db = shield::static_breaker<"payments-db">;
+//     payments_db::run([&]() { return db.query(sql); });
+//
+// Configure, when given, supplies the breaker's configuration (its name is always Name). If a breaker with
+// this name was registered first, that breaker and its configuration are used.
+template<fixed_string Name, circuit_breaker::config (*Configure)() = nullptr>
+class static_breaker final
+{
+public:
+    static constexpr std::string_view name = Name.view();
+
+    static const circuit& get_circuit()
+    {
+        static_cast<void>(registered);
+
+        static const circuit instance = circuit::pinned(make_config());
+        return instance;
+    }
+
+    static circuit_breaker& get()
+    {
+        return *get_circuit().get_circuit_breaker();
+    }
+
+    template<class _Texcept = shield::unused_exception, class Func>
+    static auto run(Func&& func)
+    {
+        return get_circuit().template run<_Texcept>(std::forward<Func>(func));
+    }
+
+private:
+    static circuit_breaker::config make_config()
+    {
+        circuit_breaker::config cfg;
+        if constexpr (Configure != nullptr)
+        {
+            cfg = Configure();
+        }
+        cfg.name = std::string(name);
+        return cfg;
+    }
+
+    // Odr-used by get_circuit(), which makes any program using this breaker register it at startup rather
+    // than on first use
+    static inline const bool registered = (get_circuit(), true);
+};
+} // shield
@@ -0,0 +1,105 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <shield/circuitbreaker.hpp>
+#include <shield/executormetrics.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace shield
+{
+// Publishes every circuit breaker's and named executor's (bulkheads included) state and counters into a
+// memory-mapped file, so another process (see the shieldstat tool) can watch them live, or inspect them after a
+// crash, without the serving process doing any scraping work. Each thread writes its counters into a lane of
+// its own in the mapping, so publishing adds no contended atomic operations to the call path.
+//
+// File layout (native endianness, POSIX only):
+//   header, 64 bytes: char[4] magic "SHST", uint32 version (3), uint32 header size, uint32 slot size,
+//                     uint32 slot capacity, uint32 pid, uint64 creation time (ms since the unix epoch),
+//                     uint32 slots in use, uint32 lane count, uint64 offset of the first lane
+//   slots, 128 bytes each: char[64] name, uint32 kind (1 breaker, 2 executor), uint32 reserved, uint32 state,
+//                     uint32 consecutive failures, uint64 transitions, uint64 last transition time,
+//                     uint64 executor capacity, uint64 counters offset, uint64 lane stride, uint64 reserved
+//   lanes, each slot capacity * 64 bytes: per slot, eight uint64 counters. A slot's counters are the sum over
+//                     every lane. Breakers count successes, failures, rejections, retries and cancellations;
+//                     executors count started, finished, queue wait ns, execution ns, then rejections by reason.
+class stats_segment final
+{
+public:
+    struct breaker_stats
+    {
+        std::string name;
+        circuit_breaker::state state = circuit_breaker::state::closed;
+        std::uint32_t failureCount = 0;
+        std::uint64_t successes = 0;
+        std::uint64_t failures = 0;
+        std::uint64_t rejections = 0;
+        std::uint64_t retries = 0;
+        std::uint64_t transitions = 0;
+        std::uint64_t lastTransitionAt = 0; ///< Milliseconds since the unix epoch, zero if never
+        std::uint64_t cancellations = 0;
+    };
+
+    struct executor_stats
+    {
+        std::string name;
+        std::uint64_t capacity = 0;
+        std::uint64_t started = 0;
+        std::uint64_t finished = 0;
+        std::array<std::uint64_t, executor_metrics::rejectionReasonCount> rejections{}; ///< By executor_metrics::rejection_reason
+        std::chrono::nanoseconds queueWaitTotal{ 0 };
+        std::chrono::nanoseconds executionTotal{ 0 };
+    };
+
+    struct contents
+    {
+        std::uint32_t pid = 0;
+        std::uint64_t createdAt = 0; ///< Milliseconds since the unix epoch
+        std::uint32_t capacity = 0; ///< Slots, shared by breakers and executors
+        std::vector<breaker_stats> breakers;
+        std::vector<executor_stats> executors;
+    };
+
+    static constexpr std::uint32_t fileVersion = 3;
+    static constexpr std::uint32_t defaultCapacity = 256;
+
+    // Creates (or truncates) the file and starts publishing every current and future breaker and named executor
+    // into it, up to capacity distinct names. Opening again switches to the new file.
+    static bool open(const std::string& path, std::uint32_t capacity = defaultCapacity);
+
+    // Stops publishing. The file is left in place for post-mortem reading. The mapping is released by a later
+    // open() or close() once calls that were writing to it when it was replaced have finished.
+    static void close();
+
+    static bool is_open();
+
+    // Reads a segment written by any process, whether it is still running or not
+    static std::optional<contents> read(const std::string& path);
+};
+} // shield
@@ -21,12 +21,20 @@
 
 #pragma once
 
-#include <boost/asio.hpp>
-//#include <boost/asio/executor_work_guard>
+#include <shield/deadline.hpp>
+#include <shield/deadlineexecutor.hpp>
+#include <shield/exceptions.hpp>
+#include <shield/probes.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <future>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <stop_token>
 #include <thread>
+#include <type_traits>
 
 namespace shield
 {
@@ -34,79 +42,110 @@ template<typename Func>
 auto with_timeout(Func&& func, std::chrono::milliseconds timeout)
 {
     using return_type = decltype(func());
+
+    // Never wait past the enclosing deadline, which the task inherits on its own thread
+    const std::chrono::milliseconds effective = call_context::clamp(timeout);
+    if (effective <= std::chrono::milliseconds::zero())
+    {
+        throw shield::deadline_exceeded_exception();
+    }
+    if (call_context::cancelled())
+    {
+        throw shield::cancelled_exception();
+    }
     
-    auto future = std::async(std::launch::async, std::forward<Func>(func));
+    // The shared state comes from the call's memory resource; the jthread's own state cannot take an allocator
+    // and stays on the global heap. The worker is joined on every path, timeouts
+    // included, so neither outlives this call. It runs in the caller's context, cancelled both by the caller
+    // and by the stop requested when it is joined, so a task that checks for cancellation ends early.
+    std::promise<return_type> promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(call_context::memory_resource()));
+    auto future = promise.get_future();
+    std::jthread worker([&promise, captured = call_context::capture(), task = std::forward<Func>(func)](std::stop_token stop) mutable
+    {
+        deadline_scope scope(captured);
+        cancellation_scope cancellable(std::move(stop));
+        try
+        {
+            if constexpr (std::is_void_v<return_type>)
+            {
+                task();
+                promise.set_value();
+            }
+            else
+            {
+                promise.set_value(task());
+            }
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+        }
+    });
     
-    if (future.wait_for(timeout) == std::future_status::timeout)
+    const std::future_status status = future.wait_for(effective);
+    if (call_context::cancelled())
     {
+        throw shield::cancelled_exception();
+    }
+    if (status == std::future_status::timeout)
+    {
+        SHIELD_PROBE1(timeout_fired, static_cast<long long>(effective.count()));
+        if (effective < timeout)
+        {
+            throw shield::deadline_exceeded_exception();
+        }
         throw std::runtime_error("Operation timed out");
     }
     
     return future.get();
 }
 
-// Alternative using Boost.Asio
-class timeout_executor final
+// As above, but runs func on executor rather than on a thread of its own, which saves starting a thread per
+// call. The call returns at the timeout without waiting for func: a task still queued is dropped, a running one
+// is asked to stop through its cancellation token and its result discarded. As the task can outlive the call,
+// its state comes from the executor's memory resource instead of the call's.
+template<typename Func>
+auto with_timeout(deadline_executor& executor, Func&& func, std::chrono::milliseconds timeout)
 {
-public:
-    timeout_executor();
-    ~timeout_executor();
-    
-    template<typename Func>
-    auto execute_with_timeout(Func&& func, std::chrono::milliseconds timeout)
+    const std::chrono::milliseconds effective = call_context::clamp(timeout);
+    if (effective <= std::chrono::milliseconds::zero())
     {
-        using return_type = decltype(func());
-        auto promise = std::make_shared<std::promise<return_type>>();
-        auto future = promise->get_future();
-        
-        boost::asio::steady_timer timer(ioContext, timeout);
-        std::atomic<bool> completed{false};
-        
-        // Execute function in separate thread
-        std::thread([func, promise, &completed]()
-        {
-            try
-            {
-                if constexpr (std::is_void_v<return_type>)
-                {
-                    func();
-                    promise->set_value();
-                }
-                else
-                {
-                    promise->set_value(func());
-                }
-                completed = true;
-            }
-            catch (...)
-            {
-                promise->set_exception(std::current_exception());
-                completed = true;
-            }
-        }).detach();
-        
-        // Setup timeout
-        timer.async_wait([promise, &completed](const boost::system::error_code& ec)
+        throw shield::deadline_exceeded_exception();
+    }
+    if (call_context::cancelled())
+    {
+        throw shield::cancelled_exception();
+    }
+
+    // Stopped when the call gives up on the task. The scope lasts until then, as it links the task's token to
+    // the caller's.
+    std::stop_source abandon;
+    cancellation_scope cancellable(abandon.get_token());
+    auto future = executor.submit(std::forward<Func>(func));
+
+    const std::future_status status = future.wait_for(effective);
+    if (call_context::cancelled())
+    {
+        abandon.request_stop();
+        throw shield::cancelled_exception();
+    }
+    if (status == std::future_status::timeout)
+    {
+        abandon.request_stop();
+        SHIELD_PROBE1(timeout_fired, static_cast<long long>(effective.count()));
+        if (effective < timeout)
         {
-            if (!ec && !completed)
-            {
-                promise->set_exception(std::make_exception_ptr(std::runtime_error("Timeout")));
-            }
-        });
-        
-        return future.get();
+            throw shield::deadline_exceeded_exception();
+        }
+        throw std::runtime_error("Operation timed out");
     }
-    
-private:
-    boost::asio::io_context ioContext;
-    //boost::asio::io_context::executor_work_guard workGuard;
 
-    std::thread thread;
-};
+    return future.get();
+}
 
 struct timeout_policy final
 {
-    timeout_policy(std::chrono::seconds timeout)
+    constexpr timeout_policy(std::chrono::seconds timeout)
         : timeout(timeout)
     {
     }
@@ -114,5 +153,5 @@ struct timeout_policy final
     std::chrono::seconds timeout;
 };
 
-static const timeout_policy default_timeout_policy = timeout_policy(std::chrono::seconds(1));
+inline constexpr timeout_policy default_timeout_policy = timeout_policy(std::chrono::seconds(1));
 } // shield
\ No newline at end of file
@@ -0,0 +1,152 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <shield/clock.hpp>
+#include <shield/deadline.hpp>
+#include <shield/deadlineexecutor.hpp>
+#include <shield/exceptions.hpp>
+#include <shield/executormetrics.hpp>
+#include <shield/probes.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+namespace shield
+{
+// Alternative using Boost.Asio. Tasks run on a deadline_executor of its own, so the most urgent caller's task
+// runs first; a task that times out while still queued is dropped rather than run.
+class timeout_executor final
+{
+public:
+    // A named executor is included in the prometheus export, see executor_metrics
+    explicit timeout_executor(const std::string& name = std::string(), std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u));
+    ~timeout_executor();
+
+    const executor_metrics& get_metrics() const { return *metrics; }
+    
+    template<typename Func>
+    auto execute_with_timeout(Func&& func, std::chrono::milliseconds timeout)
+    {
+        using return_type = decltype(func());
+
+        const std::chrono::milliseconds effective = call_context::clamp(timeout);
+        if (effective <= std::chrono::milliseconds::zero())
+        {
+            throw shield::deadline_exceeded_exception();
+        }
+        if (call_context::cancelled())
+        {
+            throw shield::cancelled_exception();
+        }
+
+        // Shared by the task and the timer, either of which may finish after this call has returned. Whichever
+        // completes first sets the result.
+        struct call_state
+        {
+            std::promise<return_type> promise;
+            std::atomic<bool> completed{ false };
+            std::stop_source abandon;
+        };
+        auto state = std::make_shared<call_state>();
+        auto future = state->promise.get_future();
+
+        // Abandoned when the timer fires first, so a task still queued is dropped and a running one asked to stop
+        cancellation_scope cancellable(state->abandon.get_token());
+        const monotonic_clock::time_point submitted = monotonic_clock::precise_now();
+        tasks.post([func = std::forward<Func>(func), state, metrics = metrics, submitted]() mutable
+        {
+            const monotonic_clock::time_point started = monotonic_clock::precise_now();
+            metrics->record_start(started - submitted);
+            try
+            {
+                if constexpr (std::is_void_v<return_type>)
+                {
+                    func();
+                    if (!state->completed.exchange(true))
+                    {
+                        state->promise.set_value();
+                    }
+                }
+                else
+                {
+                    return_type result = func();
+                    if (!state->completed.exchange(true))
+                    {
+                        state->promise.set_value(std::move(result));
+                    }
+                }
+            }
+            catch (...)
+            {
+                if (!state->completed.exchange(true))
+                {
+                    state->promise.set_exception(std::current_exception());
+                }
+            }
+            metrics->record_finish(monotonic_clock::precise_now() - started);
+        });
+
+        boost::asio::steady_timer timer(ioContext, effective);
+        timer.async_wait([state, timeout, effective, metrics = metrics](const boost::system::error_code& ec)
+        {
+            if (!ec && !state->completed.exchange(true))
+            {
+                state->abandon.request_stop();
+                SHIELD_PROBE1(timeout_fired, static_cast<long long>(effective.count()));
+                metrics->record_rejection(executor_metrics::rejection_reason::timeout);
+                if (effective < timeout)
+                {
+                    state->promise.set_exception(std::make_exception_ptr(shield::deadline_exceeded_exception()));
+                    return;
+                }
+                state->promise.set_exception(std::make_exception_ptr(std::runtime_error("Timeout")));
+            }
+        });
+
+        return future.get();
+    }
+    
+private:
+    boost::asio::io_context ioContext;
+
+    // Keeps ioContext.run() from returning while no timer is pending, until the destructor resets it
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard;
+
+    std::thread thread;
+
+    // Shared with the tasks, which may still be running when a call times out
+    std::shared_ptr<executor_metrics> metrics;
+
+    // Unnamed, as the executor's own metrics above are the ones exported
+    deadline_executor tasks;
+};
+} // shield
@@ -0,0 +1,89 @@
+/* Copyright (c) 2025 Michael Filion
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files(the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and /or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <shield/clock.hpp>
+#include <shield/function.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace shield
+{
+namespace detail
+{
+    class timer_service;
+}
+
+// Timers driven by the caller's own event loop instead of a shield thread. On Linux the service owns a
+// timerfd that becomes readable when the earliest timer is due: add native_handle() to epoll (or poll, or
+// select) and call process_expired() when it fires, which runs the due callbacks on the calling thread.
+// Elsewhere native_handle() is -1 and the loop waits until next_expiry() itself.
+//
+// Due times are monotonic_clock time points, checked against precise_now() so a timer never runs a coarse
+// clock tick early. With the manual source timers follow the simulated time when process_expired() is called;
+// the descriptor only ever follows real time.
+class timer_service final
+{
+public:
+    using callback = unique_function<void()>;
+
+    // Identifies a scheduled timer for cancel()
+    struct timer_id
+    {
+        monotonic_clock::time_point when;
+        std::uint64_t sequence = 0;
+
+        auto operator<=>(const timer_id&) const = default;
+    };
+
+    // Scheduled timers are allocated from resource, which must outlive the service
+    explicit timer_service(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~timer_service();
+
+    timer_service(const timer_service&) = delete;
+    timer_service& operator=(const timer_service&) = delete;
+
+    // May be called from any thread, including from a running callback
+    timer_id schedule_at(monotonic_clock::time_point when, callback func);
+    timer_id schedule_after(monotonic_clock::duration delay, callback func);
+
+    // False when the timer has already run or been cancelled
+    bool cancel(const timer_id& id);
+
+    // Runs every timer due now, in due order, and re-arms the descriptor for the next one. Timers scheduled
+    // by the callbacks run on a later call even if already due, so a callback rescheduling itself cannot
+    // starve the loop. Returns the number of callbacks run.
+    std::size_t process_expired();
+
+    int native_handle() const;
+    std::optional<monotonic_clock::time_point> next_expiry() const;
+    std::size_t size() const;
+
+private:
+    std::unique_ptr<detail::timer_service> pImpl;
+};
+} // shield
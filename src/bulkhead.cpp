@@ -0,0 +1,120 @@
+#include <shield/bulkhead.hpp>
+#include <shield/deadline.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <stop_token>
+
+namespace shield
+{
+struct bulkhead::waiter
+{
+    explicit waiter(size_t cost)
+        : cost(cost)
+    {
+    }
+
+    const size_t cost;
+    std::condition_variable_any wakeup; // Also woken when the waiting call is cancelled
+};
+
+bulkhead::permit bulkhead::try_acquire(size_t cost)
+{
+    if (waiting_.load() > 0 || !try_take(cost))
+    {
+        reject(executor_metrics::rejection_reason::capacity);
+        return permit();
+    }
+    return permit(this, cost);
+}
+
+bulkhead::permit bulkhead::acquire(size_t cost, std::chrono::milliseconds timeout)
+{
+    if (cost > max_concurrent_)
+    {
+        reject(executor_metrics::rejection_reason::capacity);
+        return permit();
+    }
+
+    const std::stop_token cancellation = call_context::cancellation_token();
+    if (cancellation.stop_requested())
+    {
+        reject(executor_metrics::rejection_reason::cancelled);
+        return permit();
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (queue_.empty() && try_take(cost))
+    {
+        return permit(this, cost);
+    }
+
+    waiter self(cost);
+    queue_.push_back(&self);
+    waiting_++;
+
+    // Only the oldest waiter may take units, so a large request is not overtaken by smaller ones behind it.
+    // waiting_ is raised before this check and release() lowers the count before reading waiting_, so one of
+    // the two always sees the other and the wakeup cannot be lost. A cancelled call gives up its place at once.
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+    const bool granted = self.wakeup.wait_until(lock, cancellation, deadline, [this, &self, cost]()
+    {
+        return queue_.front() == &self && try_take(cost);
+    });
+
+    const bool wasFront = queue_.front() == &self;
+    queue_.erase(std::find(queue_.begin(), queue_.end(), &self));
+    waiting_--;
+
+    // Whoever is next may fit in what is left over
+    if (wasFront)
+    {
+        wake_front();
+    }
+
+    if (!granted)
+    {
+        reject(cancellation.stop_requested() ? executor_metrics::rejection_reason::cancelled : executor_metrics::rejection_reason::timeout);
+        return permit();
+    }
+    return permit(this, cost);
+}
+
+bool bulkhead::try_take(size_t cost)
+{
+    size_t current = current_count_.load();
+    do
+    {
+        if (current + cost > max_concurrent_)
+        {
+            return false;
+        }
+    } while (!current_count_.compare_exchange_weak(current, current + cost));
+    return true;
+}
+
+void bulkhead::release(size_t cost)
+{
+    current_count_.fetch_sub(cost);
+    if (waiting_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        wake_front();
+    }
+}
+
+void bulkhead::reject(executor_metrics::rejection_reason reason)
+{
+    SHIELD_PROBE2(bulkhead_reject, current_count_.load(), max_concurrent_);
+    metrics_->record_rejection(reason);
+}
+
+// Requires queue_mutex_
+void bulkhead::wake_front()
+{
+    if (!queue_.empty())
+    {
+        queue_.front()->wakeup.notify_one();
+    }
+}
+} // shield
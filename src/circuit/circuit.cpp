@@ -1,18 +1,15 @@
 #include <shield/circuit.hpp>
 
 #include <detail/circuit/circuitbreakermanager.hpp>
+#include <detail/circuit/statecache.hpp>
 
 namespace shield
 {
 circuit::circuit(const std::string& name, std::optional<retry_policy> retry, std::optional<timeout_policy> timeout, std::optional<fallback_policy> fallback)
     : circuitBreaker(detail::circuit_breaker_manager::get_instance().get_or_create(name))
-    , retryPolicy(std::move(retry))
-    , fallbackPolicy(std::move(fallback))
+    , retryPolicy(retry ? std::make_shared<const retry_policy>(std::move(*retry)) : nullptr)
+    , fallbackPolicy(fallback ? std::make_shared<const fallback_policy>(std::move(*fallback)) : nullptr)
 {
-    if (retryPolicy.has_value() && fallbackPolicy.has_value())
-    {
-        retryPolicy->set_fallback_policy(fallbackPolicy.value());
-    }
 }
 
 circuit::circuit(std::shared_ptr<circuit_breaker> breaker)
@@ -20,50 +17,142 @@ circuit::circuit(std::shared_ptr<circuit_breaker> breaker)
 {
 }
 
+circuit::circuit(const std::string& name, std::shared_ptr<const retry_policy> retry, std::shared_ptr<const fallback_policy> fallback)
+    : circuitBreaker(detail::circuit_breaker_manager::get_instance().get_or_create(name))
+    , retryPolicy(std::move(retry))
+    , fallbackPolicy(std::move(fallback))
+{
+}
+
+circuit::circuit(std::shared_ptr<circuit_breaker> breaker, std::shared_ptr<const retry_policy> retry, std::shared_ptr<const fallback_policy> fallback)
+    : circuitBreaker(std::move(breaker))
+    , retryPolicy(std::move(retry))
+    , fallbackPolicy(std::move(fallback))
+{
+}
+
+circuit circuit::pinned(const circuit_breaker::config& cfg)
+{
+    return pin(circuit(std::shared_ptr<circuit_breaker>(nullptr)), cfg);
+}
+
+// A breaker created here has the default configuration, like one created by name
+circuit circuit::pinned(circuit unpinned)
+{
+    circuit_breaker::config cfg;
+    cfg.name = unpinned.circuitBreaker->get_name();
+    return pin(std::move(unpinned), cfg);
+}
+
+circuit circuit::pin(circuit result, const circuit_breaker::config& cfg)
+{
+    detail::circuit_breaker_manager& manager = detail::circuit_breaker_manager::get_instance();
+    result.pinnedRegistration = manager.pin(cfg);
+    result.circuitBreaker = manager.get(cfg.name);
+    return result;
+}
+
+// The fallback is handed to the retry policy on each run, so neither policy is modified or copied here
 circuit& circuit::with_retry_policy(const retry_policy& policy)
 {
-    retryPolicy = policy;
-    if (fallbackPolicy.has_value())
-    {
-        retryPolicy->set_fallback_policy(fallbackPolicy.value());
-    }
+    return with_retry_policy(std::make_shared<const retry_policy>(policy));
+}
+
+circuit& circuit::with_retry_policy(std::shared_ptr<const retry_policy> policy)
+{
+    retryPolicy = std::move(policy);
     return *this;
 }
 
 circuit& circuit::with_fallback_policy(const fallback_policy& policy)
 {
-    fallbackPolicy = policy;
-    if (retryPolicy.has_value())
-    {
-        retryPolicy->set_fallback_policy(policy);
-    }
+    return with_fallback_policy(std::make_shared<const fallback_policy>(policy));
+}
+
+circuit& circuit::with_fallback_policy(std::shared_ptr<const fallback_policy> policy)
+{
+    fallbackPolicy = std::move(policy);
     return *this;
 }
 
-void circuit::on_success() const
+circuit& circuit::with_key(std::string newKey)
 {
-    detail::circuit_breaker_manager::get_instance().on_success(circuitBreaker);
+    key = std::move(newKey);
+    return *this;
 }
 
-void circuit::on_failure() const
+void circuit::on_success(std::optional<std::chrono::nanoseconds> latency) const
 {
-    detail::circuit_breaker_manager::get_instance().on_failure(circuitBreaker);
+    if (pinnedRegistration)
+    {
+        detail::circuit_breaker_manager::get_instance().on_success(pinnedRegistration, latency, key);
+        return;
+    }
+    detail::circuit_breaker_manager::get_instance().on_success(circuitBreaker, latency, key);
+}
+
+void circuit::on_failure(const std::type_info* failureType) const
+{
+    if (pinnedRegistration)
+    {
+        detail::circuit_breaker_manager::get_instance().on_failure(pinnedRegistration, failureType, key);
+        return;
+    }
+    detail::circuit_breaker_manager::get_instance().on_failure(circuitBreaker, failureType, key);
 }
 
 bool circuit::on_execute_function() const
 {
+    if (pinnedRegistration)
+    {
+        return detail::circuit_breaker_manager::get_instance().on_execute_function(pinnedRegistration);
+    }
     return detail::circuit_breaker_manager::get_instance().on_execute_function(circuitBreaker);
 }
 
-void circuit::handle_function_exit(bool success) const
+void circuit::on_retry(std::chrono::milliseconds delay) const
+{
+    if (pinnedRegistration)
+    {
+        detail::circuit_breaker_manager::get_instance().on_retry(pinnedRegistration, delay);
+        return;
+    }
+    detail::circuit_breaker_manager::get_instance().on_retry(circuitBreaker, delay);
+}
+
+// Lets the retry policy skip the attempts an open breaker would reject, instead of sleeping only to be refused
+std::optional<monotonic_clock::time_point> circuit::next_admission() const
+{
+    return circuitBreaker ? circuitBreaker->get_next_half_open_time() : std::nullopt;
+}
+
+void circuit::handle_function_exit(bool success, std::optional<std::chrono::nanoseconds> latency, const std::type_info* failureType) const
 {
     if (success)
     {
-        on_success();
+        on_success(latency);
+    }
+    else if ((failureType == nullptr || *failureType != typeid(deadline_exceeded_exception)) && !call_context::cancelled())
+    {
+        // Running out of the caller's budget says nothing about the health of this dependency, and run()
+        // counts a cancelled call once, however many attempts it made
+        on_failure(failureType);
     }
-    else
+}
+
+namespace detail
+{
+const std::shared_ptr<shield::circuit_breaker>& callsite_breaker::resolve(const std::string& requested)
+{
+    // Read the epoch before looking up, so a registry change racing with the lookup forces another one
+    const std::uint64_t current = state_epoch::current();
+    if (!breaker || current != epoch || requested != name)
     {
-        on_failure();
+        breaker = circuit_breaker_manager::get_instance().get_or_create(requested);
+        name = requested;
+        epoch = current;
     }
+    return breaker;
 }
-} // shield
\ No newline at end of file
+} // detail
+} // shield
@@ -1,6 +1,22 @@
 #include <shield/circuitbreaker.hpp>
+#include <shield/clock.hpp>
+#include <shield/exceptions.hpp>
+#include <shield/flightrecorder.hpp>
+#include <shield/probes.hpp>
 
 #include <detail/circuit/circuitbreakermanager.hpp>
+#include <detail/circuit/eventring.hpp>
+#include <detail/circuit/heavyhitters.hpp>
+#include <detail/circuit/rollingwindow.hpp>
+#include <detail/circuit/statecache.hpp>
+#include <detail/circuit/statslayout.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <utility>
 
 namespace shield
 {
@@ -15,7 +31,22 @@ namespace detail
             , name(name)
             , failureCount(0)
             , state(shield::circuit_breaker::state::closed)
-            , lastFailureTime(std::chrono::time_point<std::chrono::steady_clock>{}) // Epoch
+            , lastFailureTime(monotonic_clock::time_point{}) // Epoch
+            , latencyThreshold(std::chrono::milliseconds::zero())
+            , latencyPercentile(0.99)
+            , minimumCalls(0)
+            , adaptiveThreshold(false)
+            , adaptiveDeviation(0.0)
+            , baselineSmoothing(0.0)
+            , baselineFloor(0.0)
+            , windowBuckets(0)
+            , baselineErrorRate(-1.0)
+            , baselineRotations(0)
+            , successSampleRate(1)
+            , keySampleRate(1)
+            , events(std::make_shared<event_ring>(shield::circuit_breaker::config().flightRecorderEvents))
+            , recordSuccesses(shield::circuit_breaker::config().flightRecorderSuccesses)
+            , stats(nullptr)
         {
         }
 
@@ -25,35 +56,265 @@ namespace detail
             , timeout(cfg.timeout)
             , failureCount(0)
             , state(shield::circuit_breaker::state::closed)
-            , lastFailureTime(std::chrono::time_point<std::chrono::steady_clock>{}) // Epoch
+            , lastFailureTime(monotonic_clock::time_point{}) // Epoch
+            , latencyThreshold(cfg.latencyThreshold)
+            , latencyPercentile(cfg.latencyPercentile)
+            , minimumCalls(cfg.minimumCalls)
+            , adaptiveThreshold(cfg.adaptiveThreshold)
+            , adaptiveDeviation(cfg.adaptiveDeviation)
+            , baselineSmoothing(cfg.baselineSmoothing)
+            , baselineFloor(cfg.baselineFloor)
+            , windowBuckets(cfg.windowBuckets)
+            , baselineErrorRate(-1.0)
+            , baselineRotations(0)
+            , successSampleRate(std::max(cfg.successSampleRate, 1))
+            , keySampleRate(std::max(cfg.keySampleRate, 1))
+            , events(cfg.flightRecorderEvents > 0 ? std::make_shared<event_ring>(static_cast<std::size_t>(cfg.flightRecorderEvents)) : nullptr)
+            , recordSuccesses(events && cfg.flightRecorderSuccesses)
+            , stats(nullptr)
         {
+            const bool trackLatency = latencyThreshold > std::chrono::milliseconds::zero();
+            if (trackLatency || adaptiveThreshold)
+            {
+                window = std::make_unique<rolling_window>(cfg.windowDuration, cfg.windowBuckets, trackLatency);
+            }
+
+            if (cfg.topKeys > 0)
+            {
+                failureKeys = std::make_unique<heavy_hitters>(static_cast<std::size_t>(cfg.topKeys));
+                latencyKeys = std::make_unique<heavy_hitters>(static_cast<std::size_t>(cfg.topKeys));
+            }
         }
 
         shield::circuit_breaker::state get_state() const { return state; }
+
+        std::optional<monotonic_clock::time_point> get_next_half_open_time()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (state != shield::circuit_breaker::state::open)
+            {
+                return std::nullopt;
+            }
+            // on_execute_function admits once strictly past the timeout
+            return lastFailureTime + timeout + monotonic_clock::duration(1);
+        }
         int get_failure_count() const { return failureCount; }
+        std::uint64_t get_cancellation_count() const { return cancellationCount.load(std::memory_order_relaxed); }
         const std::string& get_name() const { return name; }
 
-        void on_success()
+        std::optional<double> get_baseline_error_rate() const
+        {
+            const double baseline = baselineErrorRate.load(std::memory_order_relaxed);
+            return baseline < 0.0 ? std::nullopt : std::optional<double>(baseline);
+        }
+
+        std::vector<shield::circuit_breaker::key_stats> get_top_failure_keys() const { return top_keys(failureKeys.get()); }
+        std::vector<shield::circuit_breaker::key_stats> get_top_latency_keys() const { return top_keys(latencyKeys.get()); }
+
+        void on_success(std::optional<std::chrono::nanoseconds> latency, std::string_view key)
         {
+            if (latencyKeys && latency && !key.empty() && sample(keySampleRate))
+            {
+                const std::int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(*latency).count();
+                latencyKeys->record(key, static_cast<std::uint64_t>(std::max<std::int64_t>(micros, 1)) * static_cast<std::uint64_t>(keySampleRate));
+            }
+
+            stats_slot* const slot = stats.load(std::memory_order_acquire);
+            const bool sampled = (window || recordSuccesses || slot) && sample(successSampleRate);
+            if (sampled && slot)
+            {
+                stats_add(slot, breaker_counter::successes, static_cast<std::uint64_t>(successSampleRate));
+            }
+
+            if (sampled && recordSuccesses)
+            {
+                const std::int64_t micros = latency ? std::chrono::duration_cast<std::chrono::microseconds>(*latency).count() : 0;
+                events->record(static_cast<std::uint8_t>(flight_recorder::event_type::success), event_ring::saturate(micros));
+            }
+
+            if (sampled && window)
+            {
+                const auto now = monotonic_clock::now();
+                if (window->record_success(now, latency, static_cast<std::uint64_t>(successSampleRate)))
+                {
+                    evaluate_window(now, true);
+                }
+            }
+
+            // Nothing to reset while closed without pending failures, so the steady state writes nothing shared
+            if (state == shield::circuit_breaker::state::closed && failureCount == 0)
+            {
+                return;
+            }
+
             std::lock_guard<std::mutex> lock(mutex);
             failureCount = 0;
+            if (slot)
+            {
+                slot->failureCount.store(0, std::memory_order_relaxed);
+            }
             if (state == shield::circuit_breaker::state::half_open)
             {
                 std::cout << "[cb] Transitioning '" << name << "' from HALF_OPEN to CLOSED" << std::endl;
-                state = shield::circuit_breaker::state::closed;
+                transition_to(shield::circuit_breaker::state::closed);
+                if (window)
+                {
+                    // Start afresh so the latencies that opened the breaker cannot immediately re-open it
+                    window->reset();
+                }
             }
         }
 
-        void on_failure()
+        void on_failure(const std::type_info* exceptionType, std::string_view key)
         {
+            // The caller gave up on the call, which says nothing about the health of the dependency
+            if (exceptionType && *exceptionType == typeid(cancelled_exception))
+            {
+                on_cancelled();
+                return;
+            }
+
+            if (failureKeys && !key.empty() && sample(keySampleRate))
+            {
+                failureKeys->record(key, static_cast<std::uint64_t>(keySampleRate));
+            }
+
+            if (events)
+            {
+                events->record(static_cast<std::uint8_t>(flight_recorder::event_type::failure), exception_types::index_of(exceptionType));
+            }
+
+            stats_slot* const slot = stats.load(std::memory_order_acquire);
+            if (slot)
+            {
+                stats_add(slot, breaker_counter::failures);
+            }
+
+            const auto now = monotonic_clock::now();
+            if (window)
+            {
+                const bool rotated = window->record_failure(now);
+                if (rotated || adaptiveThreshold)
+                {
+                    evaluate_window(now, rotated);
+                }
+            }
+
             std::lock_guard<std::mutex> lock(mutex);
             ++failureCount;
-            lastFailureTime = std::chrono::steady_clock::now();
+            lastFailureTime = now;
+            if (slot)
+            {
+                slot->failureCount.store(static_cast<std::uint32_t>(failureCount), std::memory_order_relaxed);
+            }
 
-            if (failureCount >= failureThreshold && state != shield::circuit_breaker::state::open)
+            // Once a baseline has been learned the error rate test replaces the consecutive failure count,
+            // although any failure while half-open still re-opens the breaker
+            const bool tripped = use_error_rate_test()
+                ? state == shield::circuit_breaker::state::half_open
+                : failureCount >= failureThreshold;
+            if (tripped && state != shield::circuit_breaker::state::open)
             {
                 std::cout << "[cb] Transitioning '" << name << "' OPEN" << std::endl;
-                state = shield::circuit_breaker::state::open;
+                transition_to(shield::circuit_breaker::state::open);
+            }
+        }
+
+        // A batch of outcomes aggregated by the caller, applied as one update. The order of the calls within the
+        // batch is unknown, so the failures are taken to have come last: they can still trip the breaker after
+        // the successes have reset its consecutive failure count, and any failure re-opens a half-open breaker.
+        void record_outcomes(std::uint64_t successes, std::uint64_t failures, std::uint64_t slowCalls, const std::optional<shield::circuit_breaker::latency_summary>& latency)
+        {
+            slowCalls = std::min(slowCalls, successes);
+
+            stats_slot* const slot = stats.load(std::memory_order_acquire);
+            if (slot)
+            {
+                stats_add(slot, breaker_counter::successes, successes);
+                stats_add(slot, breaker_counter::failures, failures);
+            }
+
+            if (events)
+            {
+                if (successes != 0 && recordSuccesses)
+                {
+                    const std::int64_t micros = latency ? std::chrono::duration_cast<std::chrono::microseconds>(latency->typical).count() : 0;
+                    events->record(static_cast<std::uint8_t>(flight_recorder::event_type::success), event_ring::saturate(micros));
+                }
+                if (failures != 0)
+                {
+                    events->record(static_cast<std::uint8_t>(flight_recorder::event_type::failure), 0);
+                }
+            }
+
+            const auto now = monotonic_clock::now();
+            if (window)
+            {
+                bool rotated = false;
+                if (successes != slowCalls)
+                {
+                    rotated |= window->record_success(now, latency ? std::optional<std::chrono::nanoseconds>(latency->typical) : std::nullopt, successes - slowCalls);
+                }
+                if (slowCalls != 0)
+                {
+                    rotated |= window->record_success(now, latency ? std::optional<std::chrono::nanoseconds>(latency->slowest) : std::nullopt, slowCalls);
+                }
+                if (failures != 0)
+                {
+                    rotated |= window->record_failure(now, failures);
+                }
+                if (rotated || (adaptiveThreshold && failures != 0))
+                {
+                    evaluate_window(now, rotated);
+                }
+            }
+
+            if (successes == 0 && failures == 0)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            const bool halfOpen = state == shield::circuit_breaker::state::half_open;
+            if (successes != 0)
+            {
+                failureCount = 0;
+            }
+            if (failures != 0)
+            {
+                failureCount += static_cast<int>(std::min<std::uint64_t>(failures, INT_MAX - failureCount));
+                lastFailureTime = now;
+            }
+            if (slot)
+            {
+                slot->failureCount.store(static_cast<std::uint32_t>(failureCount), std::memory_order_relaxed);
+            }
+
+            const bool tripped = failures != 0 && (use_error_rate_test() ? halfOpen : (halfOpen || failureCount >= failureThreshold));
+            if (tripped && state != shield::circuit_breaker::state::open)
+            {
+                transition_to(shield::circuit_breaker::state::open);
+            }
+            else if (!tripped && halfOpen && successes != 0)
+            {
+                transition_to(shield::circuit_breaker::state::closed);
+                if (window)
+                {
+                    window->reset();
+                }
+            }
+        }
+
+        void on_cancelled()
+        {
+            cancellationCount.fetch_add(1, std::memory_order_relaxed);
+            if (events)
+            {
+                events->record(static_cast<std::uint8_t>(flight_recorder::event_type::cancellation), 0);
+            }
+            if (stats_slot* slot = stats.load(std::memory_order_acquire))
+            {
+                stats_add(slot, breaker_counter::cancellations);
             }
         }
 
@@ -61,15 +322,31 @@ namespace detail
         {
             if (state == shield::circuit_breaker::state::open)
             {
-                auto now = std::chrono::steady_clock::now();
-                if (now - lastFailureTime > timeout)
+                // Taken on the open path only, as outcomes update the failure time without the registry lock
+                std::lock_guard<std::mutex> lock(mutex);
+
+                // Precise, so a full timeout after the failure is never read as a tick short of it; the rare
+                // open path can afford the steady_clock read. The state is checked again as another caller may
+                // have moved the circuit on while this one waited for the lock, leaving the final return to decide.
+                auto now = monotonic_clock::precise_now();
+                const bool stillOpen = state == shield::circuit_breaker::state::open;
+                if (stillOpen && now - lastFailureTime > timeout)
                 {
                     std::cout << "Circuit transitioning to HALF_OPEN\n";
-                    state = shield::circuit_breaker::state::half_open;
+                    transition_to(shield::circuit_breaker::state::half_open);
                 }
-                else
+                else if (stillOpen)
                 {
                     //throw std::runtime_error("Circuit breaker is OPEN");
+                    SHIELD_PROBE1(breaker_reject, name.c_str());
+                    if (events)
+                    {
+                        events->record(static_cast<std::uint8_t>(flight_recorder::event_type::rejection), 0);
+                    }
+                    if (stats_slot* slot = stats.load(std::memory_order_acquire))
+                    {
+                        stats_add(slot, breaker_counter::rejections);
+                    }
                     return false;
                 }
             }
@@ -77,9 +354,175 @@ namespace detail
             return state != shield::circuit_breaker::state::open;
         }
 
-        void init(std::function<void(const std::string&, std::function<void()>, std::function<void()>, std::function<bool()>)> callback)
+        void init(unique_function<void(const std::string&, unique_function<bool()>, std::shared_ptr<event_ring>, unique_function<void(stats_slot*)>)> callback)
         {
-            callback(name, std::bind(&circuit_breaker::on_success, this), std::bind(&circuit_breaker::on_failure, this), std::bind(&circuit_breaker::on_execute_function, this));
+            callback(name,
+                [this]() { return on_execute_function(); },
+                events,
+                [this](stats_slot* slot) { attach_stats(slot); });
+        }
+
+    private:
+        // Every state change must go through here so threads holding a cached admission see it
+        void transition_to(shield::circuit_breaker::state newState)
+        {
+            const shield::circuit_breaker::state previous = state.exchange(newState);
+            state_epoch::advance();
+
+            SHIELD_PROBE3(breaker_transition, name.c_str(), static_cast<int>(previous), static_cast<int>(newState));
+
+            if (events)
+            {
+                events->record(static_cast<std::uint8_t>(flight_recorder::event_type::transition), (static_cast<std::uint32_t>(previous) << 4) | static_cast<std::uint32_t>(newState));
+            }
+
+            if (stats_slot* slot = stats.load(std::memory_order_acquire))
+            {
+                slot->state.store(static_cast<std::uint32_t>(newState), std::memory_order_relaxed);
+                slot->lastTransitionAt.store(wall_clock_millis(), std::memory_order_relaxed);
+                slot->transitions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Called by the manager when a stats segment is opened or closed, null stops publishing
+        void attach_stats(stats_slot* slot)
+        {
+            if (slot)
+            {
+                slot->state.store(static_cast<std::uint32_t>(state.load()), std::memory_order_relaxed);
+                slot->failureCount.store(static_cast<std::uint32_t>(failureCount.load()), std::memory_order_relaxed);
+            }
+            // Released so a writer that sees the slot also sees its lane layout
+            stats.store(slot, std::memory_order_release);
+        }
+
+        // Stats readers live in other processes, so their timestamps cannot use the shield clock
+        static std::uint64_t wall_clock_millis()
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        // Decides whether an outcome is recorded (with weight rate), used for successes going into the window
+        // and for keyed outcomes. The decision is taken from a hashed thread-local counter rather than a shared
+        // one so unsampled outcomes write nothing shared; hashing keeps a thread that alternates between
+        // breakers from always skipping the same one.
+        static bool sample(int rate)
+        {
+            if (rate == 1)
+            {
+                return true;
+            }
+
+            thread_local std::uint64_t counter = reinterpret_cast<std::uintptr_t>(&counter);
+            std::uint64_t z = (counter += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+            return z % static_cast<std::uint64_t>(rate) == 0;
+        }
+
+        static std::vector<shield::circuit_breaker::key_stats> top_keys(const heavy_hitters* keys)
+        {
+            std::vector<shield::circuit_breaker::key_stats> result;
+            if (keys)
+            {
+                for (heavy_hitters::entry& entry : keys->top())
+                {
+                    result.push_back({ std::move(entry.key), entry.count, entry.error });
+                }
+            }
+            return result;
+        }
+
+        bool use_error_rate_test() const
+        {
+            return adaptiveThreshold && baselineErrorRate.load(std::memory_order_relaxed) >= 0.0;
+        }
+
+        // Runs when a caller rotated the window into a new bucket (so at most once per bucket) and, in
+        // adaptive mode, on every failure
+        void evaluate_window(monotonic_clock::time_point now, bool rotated)
+        {
+            if (state != shield::circuit_breaker::state::closed)
+            {
+                return;
+            }
+
+            const rolling_window::snapshot snapshot = window->get_snapshot(now);
+
+            if (rotated && window->tracks_latency())
+            {
+                const std::uint64_t samples = std::accumulate(snapshot.latencies.begin(), snapshot.latencies.end(), std::uint64_t(0));
+                if (samples != 0 && samples >= static_cast<std::uint64_t>(minimumCalls))
+                {
+                    const std::chrono::microseconds observed = latency_histogram::percentile(snapshot.latencies, latencyPercentile);
+                    if (observed > latencyThreshold)
+                    {
+                        trip_open(now);
+                        return;
+                    }
+                }
+            }
+
+            if (adaptiveThreshold)
+            {
+                evaluate_error_rate(now, snapshot, rotated);
+            }
+        }
+
+        // Opens the breaker when the window's error rate sits more than adaptiveDeviation standard deviations
+        // above the learned baseline (a one-sided z-test on a binomial proportion). The baseline is an EWMA
+        // of the window's error rate, sampled once per bucket while the window looks normal.
+        void evaluate_error_rate(monotonic_clock::time_point now, const rolling_window::snapshot& snapshot, bool rotated)
+        {
+            const double baseline = baselineErrorRate.load(std::memory_order_relaxed);
+
+            // The first rotation opens the window's first bucket, so the window holds a full window of history
+            // once windowBuckets more have followed. Counted whatever the call volume, as idle buckets are
+            // history too.
+            const bool warmedUp = baseline >= 0.0 || (rotated && baselineRotations.fetch_add(1, std::memory_order_relaxed) >= windowBuckets);
+
+            const std::uint64_t calls = snapshot.successes + snapshot.failures;
+            if (calls == 0 || calls < static_cast<std::uint64_t>(minimumCalls))
+            {
+                return;
+            }
+
+            const double observed = static_cast<double>(snapshot.failures) / static_cast<double>(calls);
+            if (baseline < 0.0)
+            {
+                // The first full window with enough calls seeds the baseline, until then the consecutive failure
+                // threshold applies
+                if (warmedUp)
+                {
+                    baselineErrorRate.store(observed, std::memory_order_relaxed);
+                }
+                return;
+            }
+
+            const double expected = std::max(baseline, baselineFloor);
+            const double deviation = std::sqrt(expected * (1.0 - expected) / static_cast<double>(calls));
+            const double z = deviation > 0.0 ? (observed - expected) / deviation : 0.0;
+
+            if (z > adaptiveDeviation && snapshot.failures >= static_cast<std::uint64_t>(failureThreshold))
+            {
+                trip_open(now);
+            }
+            else if (rotated)
+            {
+                baselineErrorRate.store(baseline + baselineSmoothing * (observed - baseline), std::memory_order_relaxed);
+            }
+        }
+
+        // Reported like any other transition, through the flight recorder, the transition probe and the stats segment
+        void trip_open(monotonic_clock::time_point now)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (state == shield::circuit_breaker::state::closed)
+            {
+                lastFailureTime = now;
+                transition_to(shield::circuit_breaker::state::open);
+            }
         }
 
     private:
@@ -87,9 +530,29 @@ namespace detail
         const std::string name;
         std::chrono::milliseconds timeout;
         std::atomic<int> failureCount;
+        std::atomic<std::uint64_t> cancellationCount{ 0 };
         std::atomic<shield::circuit_breaker::state> state;
-        std::chrono::steady_clock::time_point lastFailureTime;
+        monotonic_clock::time_point lastFailureTime;
         std::mutex mutex;
+
+        const std::chrono::milliseconds latencyThreshold;
+        const double latencyPercentile;
+        const int minimumCalls;
+        const bool adaptiveThreshold;
+        const double adaptiveDeviation;
+        const double baselineSmoothing;
+        const double baselineFloor;
+        const int windowBuckets;
+        std::atomic<double> baselineErrorRate; // Negative until learned
+        std::atomic<int> baselineRotations; // Window rotations seen before the baseline was seeded
+        const int successSampleRate;
+        const int keySampleRate;
+        std::shared_ptr<event_ring> events; // Shared with the manager so it can be dumped
+        const bool recordSuccesses;
+        std::atomic<stats_slot*> stats; // Slot in the open stats segment, if any
+        std::unique_ptr<rolling_window> window;
+        std::unique_ptr<heavy_hitters> failureKeys; // Only with config::topKeys
+        std::unique_ptr<heavy_hitters> latencyKeys;
     };
 } // detail
 
@@ -132,9 +595,35 @@ circuit_breaker::~circuit_breaker()
 {
 }
 
-void circuit_breaker::init(std::function<void(const std::string&, std::function<void()>, std::function<void()>, std::function<bool()>)> callback)
+void circuit_breaker::init(unique_function<void(const std::string&, unique_function<bool()>, std::shared_ptr<detail::event_ring>, unique_function<void(detail::stats_slot*)>)> callback)
+{
+    pImpl->init(std::move(callback));
+}
+
+circuit_breaker::permit circuit_breaker::try_acquire()
+{
+    return pImpl->on_execute_function() ? permit(this) : permit();
+}
+
+void circuit_breaker::permit::success(std::optional<std::chrono::nanoseconds> latency)
+{
+    if (breaker)
+    {
+        std::exchange(breaker, nullptr)->on_success(latency);
+    }
+}
+
+void circuit_breaker::permit::failure(const std::type_info* exceptionType)
+{
+    if (breaker)
+    {
+        std::exchange(breaker, nullptr)->on_failure(exceptionType);
+    }
+}
+
+void circuit_breaker::permit::cancel()
 {
-    pImpl->init(callback);
+    failure(&typeid(cancelled_exception));
 }
 
 shield::circuit_breaker::state circuit_breaker::get_state() const
@@ -142,24 +631,59 @@ shield::circuit_breaker::state circuit_breaker::get_state() const
     return pImpl->get_state();
 }
 
+std::optional<monotonic_clock::time_point> circuit_breaker::get_next_half_open_time() const
+{
+    return pImpl->get_next_half_open_time();
+}
+
+void circuit_breaker::record_outcomes(std::uint64_t successes, std::uint64_t failures, std::uint64_t slow_calls, std::optional<latency_summary> latency)
+{
+    pImpl->record_outcomes(successes, failures, slow_calls, latency);
+}
+
+timer_service::timer_id circuit_breaker::when_half_open(timer_service& timers, timer_service::callback func) const
+{
+    return timers.schedule_at(get_next_half_open_time().value_or(monotonic_clock::now()), std::move(func));
+}
+
 int circuit_breaker::get_failure_count() const
 {
     return pImpl->get_failure_count();
 }
 
+std::uint64_t circuit_breaker::get_cancellation_count() const
+{
+    return pImpl->get_cancellation_count();
+}
+
 const std::string& circuit_breaker::get_name() const
 {
     return pImpl->get_name();
 }
 
-void circuit_breaker::on_success()
+std::optional<double> circuit_breaker::get_baseline_error_rate() const
+{
+    return pImpl->get_baseline_error_rate();
+}
+
+std::vector<circuit_breaker::key_stats> circuit_breaker::get_top_failure_keys() const
+{
+    return pImpl->get_top_failure_keys();
+}
+
+std::vector<circuit_breaker::key_stats> circuit_breaker::get_top_latency_keys() const
+{
+    return pImpl->get_top_latency_keys();
+}
+
+void circuit_breaker::on_success(std::optional<std::chrono::nanoseconds> latency, std::string_view key)
 {
-    pImpl->on_success();
+    pImpl->on_success(latency, key);
 }
 
-void circuit_breaker::on_failure()
+void circuit_breaker::on_failure(const std::type_info* exceptionType, std::string_view key)
 {
-    pImpl->on_failure();
+    pImpl->on_failure(exceptionType, key);
 }
 
 bool circuit_breaker::on_execute_function()
@@ -0,0 +1,302 @@
+#include <shield/flightrecorder.hpp>
+
+#include <shield/clock.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+#include <detail/circuit/eventring.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#define SHIELD_FLIGHT_RECORDER_SIGNALS 1
+#endif
+
+namespace
+{
+    constexpr char fileMagic[4] = { 'S', 'H', 'F', 'R' };
+
+    template<typename T>
+    void write_le(std::ostream& out, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            out.put(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+        }
+    }
+
+    template<typename T>
+    bool read_le(std::istream& in, T& value)
+    {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            const int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+            {
+                return false;
+            }
+            result |= static_cast<std::uint64_t>(static_cast<unsigned char>(byte)) << (8 * i);
+        }
+        value = static_cast<T>(result);
+        return true;
+    }
+
+    void write_string(std::ostream& out, const std::string& value)
+    {
+        const std::uint16_t length = static_cast<std::uint16_t>(std::min<std::size_t>(value.size(), 0xFFFF));
+        write_le(out, length);
+        out.write(value.data(), length);
+    }
+
+    bool read_string(std::istream& in, std::string& value)
+    {
+        std::uint16_t length = 0;
+        if (!read_le(in, length))
+        {
+            return false;
+        }
+        value.resize(length);
+        return static_cast<bool>(in.read(value.data(), length));
+    }
+
+    bool write_dump(const std::string& path, const std::string* breakerName)
+    {
+        std::vector<std::pair<std::string, std::shared_ptr<shield::detail::event_ring>>> rings = shield::detail::circuit_breaker_manager::get_instance().get_event_rings();
+        if (breakerName != nullptr)
+        {
+            std::erase_if(rings, [breakerName](const auto& ring) { return ring.first != *breakerName; });
+            if (rings.empty())
+            {
+                return false;
+            }
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        out.write(fileMagic, sizeof(fileMagic));
+        write_le(out, shield::flight_recorder::fileVersion);
+        write_le(out, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(shield::monotonic_clock::now().time_since_epoch()).count()));
+
+        const std::vector<std::string> typeNames = shield::detail::exception_types::names();
+        const std::uint32_t typeCount = static_cast<std::uint32_t>(std::count_if(typeNames.begin(), typeNames.end(), [](const std::string& name) { return !name.empty(); }));
+        write_le(out, typeCount);
+        for (std::size_t index = 0; index < typeNames.size(); ++index)
+        {
+            if (!typeNames[index].empty())
+            {
+                write_le(out, static_cast<std::uint32_t>(index));
+                write_string(out, typeNames[index]);
+            }
+        }
+
+        write_le(out, static_cast<std::uint32_t>(rings.size()));
+        for (const auto& [name, ring] : rings)
+        {
+            const std::vector<std::uint64_t> events = ring->snapshot();
+            write_string(out, name);
+            write_le(out, static_cast<std::uint32_t>(events.size()));
+            for (std::uint64_t event : events)
+            {
+                write_le(out, event);
+            }
+        }
+
+        return static_cast<bool>(out);
+    }
+
+#if defined(SHIELD_FLIGHT_RECORDER_SIGNALS)
+    int signalPipe[2] = { -1, -1 };
+
+    void on_dump_signal(int)
+    {
+        // Only async-signal-safe work here; the background thread does the dump
+        const char wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(signalPipe[1], &wake, 1);
+    }
+
+    class signal_dumper final
+    {
+    public:
+        signal_dumper()
+        {
+            if (::pipe(signalPipe) == 0)
+            {
+                ::fcntl(signalPipe[1], F_SETFL, ::fcntl(signalPipe[1], F_GETFL) | O_NONBLOCK);
+                thread = std::thread([this]() { run(); });
+            }
+        }
+
+        ~signal_dumper()
+        {
+            if (thread.joinable())
+            {
+                const char stop = 0;
+                [[maybe_unused]] const ssize_t written = ::write(signalPipe[1], &stop, 1);
+                thread.join();
+            }
+        }
+
+        bool is_running() const { return thread.joinable(); }
+
+        void set_directory(const std::string& dir)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            directory = dir;
+        }
+
+    private:
+        void run()
+        {
+            char command = 0;
+            while (::read(signalPipe[0], &command, 1) == 1 && command != 0)
+            {
+                std::string target;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    target = directory;
+                }
+                write_dump(target + "/shield-flight-" + std::to_string(::getpid()) + "-" + std::to_string(dumpCount++) + ".bin", nullptr);
+            }
+        }
+
+        std::mutex mutex;
+        std::string directory;
+        std::uint64_t dumpCount = 0;
+        std::thread thread;
+    };
+#endif
+}
+
+namespace shield
+{
+bool flight_recorder::dump(const std::string& path)
+{
+    return write_dump(path, nullptr);
+}
+
+bool flight_recorder::dump(const std::string& path, const std::string& breakerName)
+{
+    return write_dump(path, &breakerName);
+}
+
+std::vector<flight_recorder::event> flight_recorder::get_events(const std::string& breakerName)
+{
+    std::vector<event> events;
+    for (const auto& [name, ring] : detail::circuit_breaker_manager::get_instance().get_event_rings())
+    {
+        if (name == breakerName)
+        {
+            for (std::uint64_t raw : ring->snapshot())
+            {
+                events.push_back(decode(raw));
+            }
+        }
+    }
+    return events;
+}
+
+std::optional<flight_recorder::dump_contents> flight_recorder::read_dump(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(fileMagic)] = {};
+    if (!in.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(fileMagic)))
+    {
+        return std::nullopt;
+    }
+
+    std::uint32_t version = 0;
+    dump_contents contents;
+    if (!read_le(in, version) || version != fileVersion || !read_le(in, contents.dumpedAt))
+    {
+        return std::nullopt;
+    }
+
+    std::uint32_t typeCount = 0;
+    if (!read_le(in, typeCount))
+    {
+        return std::nullopt;
+    }
+    for (std::uint32_t i = 0; i < typeCount; ++i)
+    {
+        std::uint32_t index = 0;
+        std::string name;
+        if (!read_le(in, index) || !read_string(in, name))
+        {
+            return std::nullopt;
+        }
+        contents.exceptionTypes[index] = std::move(name);
+    }
+
+    std::uint32_t breakerCount = 0;
+    if (!read_le(in, breakerCount))
+    {
+        return std::nullopt;
+    }
+    for (std::uint32_t i = 0; i < breakerCount; ++i)
+    {
+        std::string name;
+        std::uint32_t eventCount = 0;
+        if (!read_string(in, name) || !read_le(in, eventCount))
+        {
+            return std::nullopt;
+        }
+
+        // Not reserved, as the count comes from the file and a corrupt one must not decide the allocation
+        std::vector<event>& events = contents.breakers[name];
+        for (std::uint32_t e = 0; e < eventCount; ++e)
+        {
+            std::uint64_t raw = 0;
+            if (!read_le(in, raw))
+            {
+                return std::nullopt;
+            }
+            events.push_back(decode(raw));
+        }
+    }
+
+    return contents;
+}
+
+flight_recorder::event flight_recorder::decode(std::uint64_t raw)
+{
+    return event
+    {
+        .type = static_cast<event_type>(raw >> 56),
+        .payload = static_cast<std::uint32_t>((raw >> 32) & detail::event_ring::maxPayload),
+        .timestamp = static_cast<std::uint32_t>(raw & 0xFFFFFFFFull),
+    };
+}
+
+bool flight_recorder::install_signal_handler(int signal, const std::string& directory)
+{
+#if defined(SHIELD_FLIGHT_RECORDER_SIGNALS)
+    static signal_dumper dumper;
+    if (!dumper.is_running())
+    {
+        return false;
+    }
+    dumper.set_directory(directory);
+
+    struct sigaction action = {};
+    action.sa_handler = on_dump_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return ::sigaction(signal, &action, nullptr) == 0;
+#else
+    (void)signal;
+    (void)directory;
+    return false;
+#endif
+}
+} // shield
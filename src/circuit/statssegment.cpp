@@ -0,0 +1,331 @@
+#include <shield/stats.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+#include <detail/circuit/statslayout.hpp>
+#include <detail/executormetricsregistry.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHIELD_STATS_SEGMENT 1
+#endif
+
+namespace
+{
+    // Bit n is set while a thread holds lane n. The shared lane is never handed out.
+    std::atomic<std::uint64_t> claimedLanes{ std::uint64_t(1) << shield::detail::sharedStatsLane };
+
+    static_assert(shield::detail::statsLanes <= 64);
+    constexpr std::uint64_t allLanes = shield::detail::statsLanes == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << shield::detail::statsLanes) - 1;
+
+#if defined(SHIELD_STATS_SEGMENT)
+    std::size_t segment_size(std::uint32_t capacity)
+    {
+        return sizeof(shield::detail::stats_header) + std::size_t(capacity) * sizeof(shield::detail::stats_slot)
+            + std::size_t(shield::detail::statsLanes) * capacity * sizeof(shield::detail::stats_counters);
+    }
+
+    // Maps a whole file, returning null on failure
+    void* map_file(const std::string& path, bool writable, std::size_t& size)
+    {
+        if (writable)
+        {
+            // Replace rather than truncate, in case this process (or another) still has the old file mapped
+            ::unlink(path.c_str());
+        }
+
+        const int fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_EXCL) : O_RDONLY, 0644);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        bool sized = true;
+        if (writable)
+        {
+            sized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+        }
+        else
+        {
+            struct stat info = {};
+            sized = ::fstat(fd, &info) == 0;
+            size = static_cast<std::size_t>(info.st_size);
+        }
+
+        void* base = sized && size != 0 ? ::mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        return base == MAP_FAILED ? nullptr : base;
+    }
+
+    class stats_mapping final
+    {
+    public:
+        stats_mapping(void* base, std::size_t size, std::uint32_t capacity)
+            : size(size)
+            , header(static_cast<shield::detail::stats_header*>(base))
+            , slots(reinterpret_cast<shield::detail::stats_slot*>(static_cast<char*>(base) + sizeof(shield::detail::stats_header)))
+        {
+            header->version = shield::detail::statsVersion;
+            header->headerSize = sizeof(shield::detail::stats_header);
+            header->slotSize = sizeof(shield::detail::stats_slot);
+            header->slotCapacity = capacity;
+            header->pid = static_cast<std::uint32_t>(::getpid());
+            header->createdAt = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+            header->slotCount.store(0, std::memory_order_relaxed);
+            header->laneCount = shield::detail::statsLanes;
+            header->countersOffset = sizeof(shield::detail::stats_header) + std::size_t(capacity) * sizeof(shield::detail::stats_slot);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(header->magic, shield::detail::statsMagic, sizeof(header->magic));
+        }
+
+        ~stats_mapping()
+        {
+            ::munmap(header, size);
+        }
+
+        stats_mapping(const stats_mapping&) = delete;
+        stats_mapping& operator=(const stats_mapping&) = delete;
+
+        // Slots are keyed by kind and the full name, so a breaker or executor that is destroyed and re-created
+        // keeps its counters
+        shield::detail::stats_slot* slot_for(shield::detail::stats_kind kind, const std::string& name, std::size_t capacity = 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const auto iter = slotsByName.find({ kind, name });
+            if (iter != slotsByName.end())
+            {
+                return iter->second;
+            }
+
+            const std::uint32_t index = header->slotCount.load(std::memory_order_relaxed);
+            if (index >= header->slotCapacity)
+            {
+                return nullptr;
+            }
+
+            shield::detail::stats_slot* slot = &slots[index];
+            const std::size_t length = std::min(name.size(), shield::detail::stats_slot::nameLength - 1);
+            std::memcpy(slot->name, name.data(), length);
+            slot->name[length] = '\0';
+            slot->kind = kind;
+            slot->capacity = capacity;
+            slot->countersOffset = header->countersOffset + std::size_t(index) * sizeof(shield::detail::stats_counters) - (reinterpret_cast<char*>(slot) - reinterpret_cast<char*>(header));
+            slot->laneStride = std::size_t(header->slotCapacity) * sizeof(shield::detail::stats_counters);
+            header->slotCount.store(index + 1, std::memory_order_release);
+
+            slotsByName.emplace(std::make_pair(kind, name), slot);
+            return slot;
+        }
+
+    private:
+        const std::size_t size;
+        shield::detail::stats_header* header;
+        shield::detail::stats_slot* slots;
+        std::mutex mutex;
+        std::map<std::pair<shield::detail::stats_kind, std::string>, shield::detail::stats_slot*> slotsByName;
+    };
+
+    std::mutex segmentMutex;
+    std::shared_ptr<stats_mapping> segment;
+
+    // A call may load its slot, block for any length of time (on_failure waits for the breaker's mutex) and only
+    // then write to it, and nothing tracks how many such calls are in flight. Replaced mappings are therefore
+    // kept until the process exits rather than unmapped; segments are opened rarely enough for that to be cheap.
+    std::vector<std::shared_ptr<stats_mapping>> retired;
+
+    // Requires segmentMutex
+    void retire(std::shared_ptr<stats_mapping> mapping)
+    {
+        if (mapping)
+        {
+            retired.push_back(std::move(mapping));
+        }
+    }
+#endif
+}
+
+namespace shield
+{
+namespace detail
+{
+stats_lane_claim::stats_lane_claim()
+    : lane(sharedStatsLane)
+{
+    std::uint64_t claimed = claimedLanes.load(std::memory_order_relaxed);
+    while (claimed != allLanes)
+    {
+        const std::uint32_t free = static_cast<std::uint32_t>(std::countr_one(claimed));
+        if (claimedLanes.compare_exchange_weak(claimed, claimed | (std::uint64_t(1) << free), std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            lane = free;
+            break;
+        }
+    }
+}
+
+stats_lane_claim::~stats_lane_claim()
+{
+    // Released, so the next thread to claim the lane continues from this thread's last writes
+    if (lane != sharedStatsLane)
+    {
+        claimedLanes.fetch_and(~(std::uint64_t(1) << lane), std::memory_order_release);
+    }
+}
+} // detail
+
+bool stats_segment::open(const std::string& path, std::uint32_t capacity)
+{
+#if defined(SHIELD_STATS_SEGMENT)
+    std::size_t size = segment_size(capacity);
+    void* base = map_file(path, true, size);
+    if (base == nullptr)
+    {
+        return false;
+    }
+
+    std::shared_ptr<stats_mapping> mapping = std::make_shared<stats_mapping>(base, size, capacity);
+    std::shared_ptr<stats_mapping> previous;
+    {
+        std::lock_guard<std::mutex> lock(segmentMutex);
+        previous = std::exchange(segment, mapping);
+    }
+
+    // Not under segmentMutex: registering a breaker takes the manager's lock and then asks for a slot
+    detail::circuit_breaker_manager::get_instance().attach_stats([mapping](const std::string& name) { return mapping->slot_for(detail::stats_kind::breaker, name); });
+    detail::executor_metrics_registry::get_instance().attach_stats([mapping](const std::string& name, std::size_t executorCapacity)
+    {
+        return mapping->slot_for(detail::stats_kind::executor, name, executorCapacity);
+    });
+
+    std::lock_guard<std::mutex> lock(segmentMutex);
+    retire(std::move(previous));
+    return true;
+#else
+    (void)path;
+    (void)capacity;
+    return false;
+#endif
+}
+
+void stats_segment::close()
+{
+#if defined(SHIELD_STATS_SEGMENT)
+    detail::circuit_breaker_manager::get_instance().detach_stats();
+    detail::executor_metrics_registry::get_instance().detach_stats();
+
+    std::lock_guard<std::mutex> lock(segmentMutex);
+    retire(std::exchange(segment, nullptr));
+#endif
+}
+
+bool stats_segment::is_open()
+{
+#if defined(SHIELD_STATS_SEGMENT)
+    std::lock_guard<std::mutex> lock(segmentMutex);
+    return segment != nullptr;
+#else
+    return false;
+#endif
+}
+
+std::optional<stats_segment::contents> stats_segment::read(const std::string& path)
+{
+#if defined(SHIELD_STATS_SEGMENT)
+    std::size_t size = 0;
+    void* base = map_file(path, false, size);
+    if (base == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    const detail::stats_header* header = static_cast<const detail::stats_header*>(base);
+    const bool valid = size >= sizeof(detail::stats_header)
+        && std::memcmp(header->magic, detail::statsMagic, sizeof(header->magic)) == 0
+        && header->version == fileVersion
+        && header->headerSize == sizeof(detail::stats_header)
+        && header->slotSize == sizeof(detail::stats_slot)
+        && header->laneCount != 0
+        && header->countersOffset == sizeof(detail::stats_header) + std::size_t(header->slotCapacity) * sizeof(detail::stats_slot)
+        && size >= header->countersOffset + std::size_t(header->laneCount) * header->slotCapacity * sizeof(detail::stats_counters);
+    if (!valid)
+    {
+        ::munmap(base, size);
+        return std::nullopt;
+    }
+
+    contents result;
+    result.pid = header->pid;
+    result.createdAt = header->createdAt;
+    result.capacity = header->slotCapacity;
+
+    const detail::stats_slot* slots = reinterpret_cast<const detail::stats_slot*>(static_cast<const char*>(base) + sizeof(detail::stats_header));
+    const detail::stats_counters* lanes = reinterpret_cast<const detail::stats_counters*>(static_cast<const char*>(base) + header->countersOffset);
+    const std::uint32_t count = std::min(header->slotCount.load(std::memory_order_acquire), header->slotCapacity);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        // Every lane's share of the slot's counters
+        std::array<std::uint64_t, detail::stats_counters::count> counters{};
+        for (std::uint32_t lane = 0; lane < header->laneCount; ++lane)
+        {
+            const detail::stats_counters& laneCounters = lanes[std::size_t(lane) * header->slotCapacity + i];
+            for (std::size_t c = 0; c < counters.size(); ++c)
+            {
+                counters[c] += laneCounters.values[c].load(std::memory_order_relaxed);
+            }
+        }
+
+        const detail::stats_slot& slot = slots[i];
+        const std::string name(slot.name, ::strnlen(slot.name, detail::stats_slot::nameLength));
+        if (slot.kind == detail::stats_kind::executor)
+        {
+            executor_stats stats;
+            stats.name = name;
+            stats.capacity = slot.capacity;
+            stats.started = counters[static_cast<std::size_t>(detail::executor_counter::started)];
+            stats.finished = counters[static_cast<std::size_t>(detail::executor_counter::finished)];
+            stats.queueWaitTotal = std::chrono::nanoseconds(counters[static_cast<std::size_t>(detail::executor_counter::queueWaitNanos)]);
+            stats.executionTotal = std::chrono::nanoseconds(counters[static_cast<std::size_t>(detail::executor_counter::executionNanos)]);
+            for (std::size_t reason = 0; reason < stats.rejections.size(); ++reason)
+            {
+                stats.rejections[reason] = counters[static_cast<std::size_t>(detail::executor_counter::rejections) + reason];
+            }
+            result.executors.push_back(std::move(stats));
+            continue;
+        }
+
+        breaker_stats stats;
+        stats.name = name;
+        stats.state = static_cast<circuit_breaker::state>(slot.state.load(std::memory_order_relaxed));
+        stats.failureCount = slot.failureCount.load(std::memory_order_relaxed);
+        stats.successes = counters[static_cast<std::size_t>(detail::breaker_counter::successes)];
+        stats.failures = counters[static_cast<std::size_t>(detail::breaker_counter::failures)];
+        stats.rejections = counters[static_cast<std::size_t>(detail::breaker_counter::rejections)];
+        stats.retries = counters[static_cast<std::size_t>(detail::breaker_counter::retries)];
+        stats.cancellations = counters[static_cast<std::size_t>(detail::breaker_counter::cancellations)];
+        stats.transitions = slot.transitions.load(std::memory_order_relaxed);
+        stats.lastTransitionAt = slot.lastTransitionAt.load(std::memory_order_relaxed);
+        result.breakers.push_back(std::move(stats));
+    }
+
+    ::munmap(base, size);
+    return result;
+#else
+    (void)path;
+    return std::nullopt;
+#endif
+}
+} // shield
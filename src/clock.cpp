@@ -0,0 +1,103 @@
+#include <shield/clock.hpp>
+
+#include <thread>
+
+namespace
+{
+    void publish_steady_now(std::atomic<std::int64_t>& target)
+    {
+        target.store(shield::monotonic_clock::from_steady(std::chrono::steady_clock::now()).time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Publishes the steady clock into monotonic_clock every millisecond once the ticker source is selected
+    class ticker final
+    {
+    public:
+        ticker(std::atomic<std::int64_t>& target)
+            : running(true)
+            , thread([this, &target]()
+            {
+                while (running.load(std::memory_order_relaxed))
+                {
+                    // Leave the published time alone once another source, such as manual, has been selected
+                    if (shield::monotonic_clock::get_source() == shield::monotonic_clock::source::ticker)
+                    {
+                        publish_steady_now(target);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            })
+        {
+        }
+
+        ~ticker()
+        {
+            running = false;
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+
+    private:
+        std::atomic<bool> running;
+        std::thread thread;
+    };
+
+    void ensure_ticker_started(std::atomic<std::int64_t>& target)
+    {
+        static ticker instance(target);
+    }
+
+}
+
+namespace shield
+{
+#if defined(CLOCK_MONOTONIC_COARSE)
+std::atomic<monotonic_clock::source> monotonic_clock::currentSource{ monotonic_clock::source::coarse };
+#else
+std::atomic<monotonic_clock::source> monotonic_clock::currentSource{ monotonic_clock::source::precise };
+#endif
+alignas(64) std::atomic<monotonic_clock::rep> monotonic_clock::publishedTime{ 0 };
+
+void monotonic_clock::set_source(source newSource)
+{
+#if !defined(CLOCK_MONOTONIC_COARSE)
+    if (newSource == source::coarse)
+    {
+        newSource = source::ticker;
+    }
+#endif
+
+    switch (newSource)
+    {
+    case source::ticker:
+        // Seed before switching so readers never observe the unset value
+        publish_steady_now(publishedTime);
+        ensure_ticker_started(publishedTime);
+        break;
+
+    case source::manual:
+        if (currentSource.load(std::memory_order_relaxed) != source::manual)
+        {
+            publish_steady_now(publishedTime);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    currentSource.store(newSource, std::memory_order_relaxed);
+}
+
+void monotonic_clock::set_time(time_point tp) noexcept
+{
+    publishedTime.store(tp.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void monotonic_clock::advance(duration delta) noexcept
+{
+    publishedTime.fetch_add(delta.count(), std::memory_order_relaxed);
+}
+} // shield
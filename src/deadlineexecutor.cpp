@@ -0,0 +1,190 @@
+#include <shield/deadlineexecutor.hpp>
+
+#include <detail/pairingheap.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shield
+{
+namespace detail
+{
+    class deadline_executor final
+    {
+    public:
+        deadline_executor(std::size_t threadCount, const std::string& name, std::pmr::memory_resource* resource)
+            : metrics(name, threadCount)
+            , resource(resource)
+            , queue(resource)
+        {
+            threads.reserve(threadCount);
+            for (std::size_t i = 0; i < threadCount; ++i)
+            {
+                threads.emplace_back([this]() { work(); });
+            }
+        }
+
+        ~deadline_executor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wakeup.notify_all();
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        void enqueue(call_context context, unique_function<void(std::exception_ptr)> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push(item{ context.deadline, ++lastSequence, monotonic_clock::precise_now(), std::move(context), std::move(task) });
+            }
+            wakeup.notify_one();
+        }
+
+        std::size_t get_queued_count() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return queue.size();
+        }
+
+        const shield::executor_metrics& get_metrics() const
+        {
+            return metrics;
+        }
+
+        std::pmr::memory_resource* get_memory_resource() const
+        {
+            return resource;
+        }
+
+    private:
+        struct item
+        {
+            std::optional<monotonic_clock::time_point> deadline;
+            std::uint64_t sequence;
+            monotonic_clock::time_point submitted;
+            call_context context;
+            unique_function<void(std::exception_ptr)> task;
+        };
+
+        // Earliest deadline first, no deadline last, submission order between equals
+        struct earlier
+        {
+            bool operator()(const item& lhs, const item& rhs) const
+            {
+                if (lhs.deadline != rhs.deadline)
+                {
+                    return lhs.deadline && (!rhs.deadline || *lhs.deadline < *rhs.deadline);
+                }
+                return lhs.sequence < rhs.sequence;
+            }
+        };
+
+        void work()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                wakeup.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (stopping)
+                {
+                    return;
+                }
+
+                item next = queue.pop();
+                lock.unlock();
+
+                const monotonic_clock::time_point started = monotonic_clock::precise_now();
+                if (next.deadline && started >= *next.deadline)
+                {
+                    metrics.record_rejection(shield::executor_metrics::rejection_reason::expired);
+                    next.task(std::make_exception_ptr(deadline_exceeded_exception()));
+                }
+                else if (next.context.cancellation.stop_requested())
+                {
+                    metrics.record_rejection(shield::executor_metrics::rejection_reason::cancelled);
+                    next.task(std::make_exception_ptr(cancelled_exception()));
+                }
+                else
+                {
+                    metrics.record_start(started - next.submitted);
+                    {
+                        deadline_scope scope(next.context);
+                        next.task(nullptr);
+                    }
+                    metrics.record_finish(monotonic_clock::precise_now() - started);
+                }
+
+                lock.lock();
+            }
+        }
+
+    private:
+        shield::executor_metrics metrics;
+        std::pmr::memory_resource* const resource;
+        mutable std::mutex mutex;
+        std::condition_variable wakeup;
+        pairing_heap<item, earlier> queue;
+        std::uint64_t lastSequence = 0;
+        bool stopping = false;
+        std::vector<std::thread> threads; // Last, so the threads start once everything else is constructed
+    };
+} // detail
+
+deadline_executor::deadline_executor(std::size_t threads, const std::string& name, std::pmr::memory_resource* resource)
+    : pImpl(std::make_unique<detail::deadline_executor>(threads, name, resource))
+{
+}
+
+deadline_executor::~deadline_executor()
+{
+}
+
+void deadline_executor::post(unique_function<void()> func)
+{
+    enqueue(call_context::capture(), [func = std::move(func)](std::exception_ptr dropped) mutable
+    {
+        if (dropped)
+        {
+            return;
+        }
+
+        try
+        {
+            func();
+        }
+        catch (...)
+        {
+            // Nobody is waiting for the result, so there is nowhere to report it
+        }
+    });
+}
+
+std::size_t deadline_executor::get_queued_count() const
+{
+    return pImpl->get_queued_count();
+}
+
+const executor_metrics& deadline_executor::get_metrics() const
+{
+    return pImpl->get_metrics();
+}
+
+std::pmr::memory_resource* deadline_executor::get_memory_resource() const
+{
+    return pImpl->get_memory_resource();
+}
+
+void deadline_executor::enqueue(call_context context, unique_function<void(std::exception_ptr)> task)
+{
+    pImpl->enqueue(std::move(context), std::move(task));
+}
+} // shield
@@ -1,11 +1,12 @@
 #include <detail/circuit/circuitbreakermanager.hpp>
 
-#include <mutex>
+#include <shield/flightrecorder.hpp>
 
-namespace
-{
-    static shield::detail::circuit_breaker_manager instance;
-}
+#include <detail/circuit/eventring.hpp>
+#include <detail/circuit/statecache.hpp>
+#include <detail/circuit/statslayout.hpp>
+
+#include <mutex>
 
 namespace shield
 {
@@ -20,9 +21,14 @@ namespace impl
         {
             std::shared_ptr<shield::circuit_breaker> instance;
 
-            std::function<void()> successFunc;
-            std::function<void()> failureFunc;
-            std::function<bool()> executeFunc;
+            unique_function<bool()> executeFunc;
+
+            std::shared_ptr<event_ring> events;
+
+            unique_function<void(stats_slot*)> statsFunc;
+            stats_slot* stats = nullptr;
+
+            bool pinned = false; // Kept by clear(), so pointers to it stay valid for the life of the process
         };
 
     public:
@@ -35,11 +41,17 @@ namespace impl
             {
                 circuit_registration registration
                 {
-                    .instance = shield::circuit_breaker::create(cfg)
+                    .instance = shield::circuit_breaker::create(cfg),
+                    .executeFunc = nullptr,
+                    .events = nullptr,
+                    .statsFunc = nullptr,
+                    .stats = nullptr,
+                    .pinned = false
                 };
 
                 auto [addedIter, added] = circuitBreakers.emplace(cfg.name, std::move(registration));
-                addedIter->second.instance->init(std::bind(&circuit_breaker_manager::register_instance, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+                addedIter->second.instance->init([this](auto&&... args) { register_instance(std::forward<decltype(args)>(args)...); });
+                attach_stats(addedIter->second);
 
                 return addedIter->second.instance;
             }
@@ -80,49 +92,92 @@ namespace impl
             return instance;
         }
 
+        const circuit_registration* pin(const shield::circuit_breaker::config& cfg)
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
+            create(cfg);
+            circuit_registration& registration = circuitBreakers.at(cfg.name);
+            registration.pinned = true;
+            return &registration;
+        }
+
         void clear()
         {
             std::lock_guard<std::recursive_mutex> lock(mutex);
 
-            circuitBreakers.clear();
+            for (auto iter = circuitBreakers.begin(); iter != circuitBreakers.end();)
+            {
+                iter = iter->second.pinned ? std::next(iter) : circuitBreakers.erase(iter);
+            }
+            state_epoch::advance();
         }
 
-        void on_success(std::shared_ptr<shield::circuit_breaker> cb) const
+        void on_retry(const std::shared_ptr<shield::circuit_breaker>& cb, std::chrono::milliseconds delay) const
         {
             std::lock_guard<std::recursive_mutex> lock(mutex);
 
             const auto iter = circuitBreakers.find(cb->get_name());
             if (iter != circuitBreakers.end())
             {
-                iter->second.successFunc();
+                record_retry(iter->second, delay);
             }
         }
 
-        void on_failure(std::shared_ptr<shield::circuit_breaker> cb) const
+        void on_retry(const circuit_registration& registration, std::chrono::milliseconds delay) const
         {
             std::lock_guard<std::recursive_mutex> lock(mutex);
+            record_retry(registration, delay);
+        }
 
-            const auto iter = circuitBreakers.find(cb->get_name());
-            if (iter != circuitBreakers.end())
+        std::vector<std::pair<std::string, std::shared_ptr<event_ring>>> get_event_rings() const
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
+            std::vector<std::pair<std::string, std::shared_ptr<event_ring>>> rings;
+            for (const auto& [name, registration] : circuitBreakers)
             {
-                iter->second.failureFunc();
+                if (registration.events)
+                {
+                    rings.emplace_back(name, registration.events);
+                }
             }
+            return rings;
         }
 
-        bool on_execute_function(std::shared_ptr<shield::circuit_breaker> cb) const
+        bool on_execute_function(const std::shared_ptr<shield::circuit_breaker>& cb) const
         {
+            // Read the epoch before the state so a transition racing with this call invalidates what we cache
+            const std::uint64_t epoch = state_epoch::current();
+            if (admission_cache::is_closed(cb.get(), epoch))
+            {
+                return true;
+            }
+
             std::lock_guard<std::recursive_mutex> lock(mutex);
 
             const auto iter = circuitBreakers.find(cb->get_name());
             if (iter != circuitBreakers.end())
             {
-                return iter->second.executeFunc();
+                return execute(iter->second, epoch);
             }
 
             return false;
         }
 
-        void register_circuit_breaker(std::shared_ptr<shield::circuit_breaker> cb)
+        bool on_execute_function(const circuit_registration& registration) const
+        {
+            const std::uint64_t epoch = state_epoch::current();
+            if (admission_cache::is_closed(registration.instance.get(), epoch))
+            {
+                return true;
+            }
+
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            return execute(registration, epoch);
+        }
+
+        void register_circuit_breaker(const std::shared_ptr<shield::circuit_breaker>& cb)
         {
             std::lock_guard<std::recursive_mutex> lock(mutex);
 
@@ -131,31 +186,94 @@ namespace impl
             {
                 circuit_registration registration
                 {
-                    .instance = cb
+                    .instance = cb,
+                    .executeFunc = nullptr,
+                    .events = nullptr,
+                    .statsFunc = nullptr,
+                    .stats = nullptr,
+                    .pinned = false
                 };
 
                 auto [addedIter, added] = circuitBreakers.emplace(cb->get_name(), std::move(registration));
-                addedIter->second.instance->init(std::bind(&circuit_breaker_manager::register_instance, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+                addedIter->second.instance->init([this](auto&&... args) { register_instance(std::forward<decltype(args)>(args)...); });
+                attach_stats(addedIter->second);
+                state_epoch::advance();
+            }
+        }
+
+        void attach_stats(std::function<stats_slot*(const std::string&)> slotFor)
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
+            statsSlotFor = std::move(slotFor);
+            for (auto& [name, registration] : circuitBreakers)
+            {
+                attach_stats(registration);
+            }
+        }
+
+        void detach_stats()
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
+            statsSlotFor = nullptr;
+            for (auto& [name, registration] : circuitBreakers)
+            {
+                attach_stats(registration);
             }
         }
 
     private:
-        void register_instance(const std::string& name, std::function<void()> successFunc, std::function<void()> failureFunc, std::function<bool()> executeFunc)
+        // Requires the mutex
+        bool execute(const circuit_registration& registration, std::uint64_t epoch) const
+        {
+            const bool admitted = registration.executeFunc();
+            if (admitted && registration.instance->get_state() == shield::circuit_breaker::state::closed)
+            {
+                admission_cache::set_closed(registration.instance.get(), epoch);
+            }
+            return admitted;
+        }
+
+        // Requires the mutex
+        void record_retry(const circuit_registration& registration, std::chrono::milliseconds delay) const
+        {
+            if (registration.events)
+            {
+                registration.events->record(static_cast<std::uint8_t>(flight_recorder::event_type::retry), event_ring::saturate(delay.count()));
+            }
+            if (registration.stats)
+            {
+                stats_add(registration.stats, breaker_counter::retries);
+            }
+        }
+
+        void attach_stats(circuit_registration& registration)
+        {
+            registration.stats = statsSlotFor ? statsSlotFor(registration.instance->get_name()) : nullptr;
+            if (registration.statsFunc)
+            {
+                registration.statsFunc(registration.stats);
+            }
+        }
+
+        void register_instance(const std::string& name, unique_function<bool()> executeFunc, std::shared_ptr<event_ring> events, unique_function<void(stats_slot*)> statsFunc)
         {
             std::lock_guard<std::recursive_mutex> lock(mutex);
 
             const auto iter = circuitBreakers.find(name);
             if (iter != circuitBreakers.end())
             {
-                iter->second.successFunc = successFunc;
-                iter->second.failureFunc = failureFunc;
-                iter->second.executeFunc = executeFunc;
+                iter->second.executeFunc = std::move(executeFunc);
+                iter->second.events = std::move(events);
+                iter->second.statsFunc = std::move(statsFunc);
             }
         }
 
     private:
         mutable std::recursive_mutex mutex;
         std::unordered_map<std::string, circuit_registration> circuitBreakers;
+        std::function<stats_slot*(const std::string&)> statsSlotFor; // Set while a stats segment is open
     };
 } // impl
 
@@ -184,32 +302,82 @@ std::shared_ptr<shield::circuit_breaker> circuit_breaker_manager::get_or_create(
     return pImpl->get_or_create(name);
 }
 
+// A function-local static, so breakers registered during static initialisation (see static_breaker) never
+// see the manager before it is constructed
 circuit_breaker_manager& circuit_breaker_manager::get_instance()
 {
+    static circuit_breaker_manager instance;
     return instance;
 }
 
+circuit_breaker_manager::pinned_registration circuit_breaker_manager::pin(const shield::circuit_breaker::config& cfg)
+{
+    return pImpl->pin(cfg);
+}
+
 void circuit_breaker_manager::clear()
 {
     return pImpl->clear();
 }
 
-void circuit_breaker_manager::on_success(std::shared_ptr<shield::circuit_breaker> cb) const
+// Outcomes go straight to the breaker, which is safe to call from any thread, so reporting one takes neither
+// the registry lock nor a lookup by name
+void circuit_breaker_manager::on_success(const std::shared_ptr<shield::circuit_breaker>& cb, std::optional<std::chrono::nanoseconds> latency, std::string_view key) const
+{
+    cb->on_success(latency, key);
+}
+
+void circuit_breaker_manager::on_failure(const std::shared_ptr<shield::circuit_breaker>& cb, const std::type_info* exceptionType, std::string_view key) const
+{
+    cb->on_failure(exceptionType, key);
+}
+
+void circuit_breaker_manager::on_retry(const std::shared_ptr<shield::circuit_breaker>& cb, std::chrono::milliseconds delay) const
+{
+    pImpl->on_retry(cb, delay);
+}
+
+void circuit_breaker_manager::on_success(pinned_registration registration, std::optional<std::chrono::nanoseconds> latency, std::string_view key) const
+{
+    static_cast<const impl::circuit_breaker_manager::circuit_registration*>(registration)->instance->on_success(latency, key);
+}
+
+void circuit_breaker_manager::on_failure(pinned_registration registration, const std::type_info* exceptionType, std::string_view key) const
+{
+    static_cast<const impl::circuit_breaker_manager::circuit_registration*>(registration)->instance->on_failure(exceptionType, key);
+}
+
+bool circuit_breaker_manager::on_execute_function(pinned_registration registration) const
+{
+    return pImpl->on_execute_function(*static_cast<const impl::circuit_breaker_manager::circuit_registration*>(registration));
+}
+
+void circuit_breaker_manager::on_retry(pinned_registration registration, std::chrono::milliseconds delay) const
+{
+    pImpl->on_retry(*static_cast<const impl::circuit_breaker_manager::circuit_registration*>(registration), delay);
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<event_ring>>> circuit_breaker_manager::get_event_rings() const
+{
+    return pImpl->get_event_rings();
+}
+
+void circuit_breaker_manager::attach_stats(std::function<stats_slot*(const std::string&)> slotFor)
 {
-    pImpl->on_success(cb);
+    pImpl->attach_stats(std::move(slotFor));
 }
 
-void circuit_breaker_manager::on_failure(std::shared_ptr<shield::circuit_breaker> cb) const
+void circuit_breaker_manager::detach_stats()
 {
-    pImpl->on_failure(cb);
+    pImpl->detach_stats();
 }
 
-bool circuit_breaker_manager::on_execute_function(std::shared_ptr<shield::circuit_breaker> cb) const
+bool circuit_breaker_manager::on_execute_function(const std::shared_ptr<shield::circuit_breaker>& cb) const
 {
     return pImpl->on_execute_function(cb);
 }
 
-void circuit_breaker_manager::register_circuit_breaker(std::shared_ptr<shield::circuit_breaker> cb)
+void circuit_breaker_manager::register_circuit_breaker(const std::shared_ptr<shield::circuit_breaker>& cb)
 {
     pImpl->register_circuit_breaker(cb);
 }
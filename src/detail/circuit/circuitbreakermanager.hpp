@@ -2,10 +2,16 @@
 
 #include <shield/circuitbreaker.hpp>
 
+#include <utility>
+#include <vector>
+
 namespace shield
 {
 namespace detail
 {
+class event_ring;
+struct stats_slot;
+
 namespace impl
 {
     class circuit_breaker_manager;
@@ -14,6 +20,9 @@ namespace impl
 class circuit_breaker_manager final
 {
 public:
+    // Opaque reference to a pinned breaker's registration
+    using pinned_registration = const void*;
+
     circuit_breaker_manager();
     ~circuit_breaker_manager() = default;
 
@@ -24,13 +33,30 @@ public:
 
     static circuit_breaker_manager& get_instance();
 
+    // Creates (or finds) the breaker and keeps it registered for the life of the process, clear() included.
+    // Calls made through the returned registration skip the lookup by name.
+    pinned_registration pin(const shield::circuit_breaker::config& cfg);
+
+    // Removes every breaker that is not pinned
     void clear();
 
-    void on_success(std::shared_ptr<shield::circuit_breaker> cb) const;
-    void on_failure(std::shared_ptr<shield::circuit_breaker> cb) const;
-    bool on_execute_function(std::shared_ptr<shield::circuit_breaker> cb) const;
+    void on_success(const std::shared_ptr<shield::circuit_breaker>& cb, std::optional<std::chrono::nanoseconds> latency = std::nullopt, std::string_view key = {}) const;
+    void on_failure(const std::shared_ptr<shield::circuit_breaker>& cb, const std::type_info* exceptionType = nullptr, std::string_view key = {}) const;
+    bool on_execute_function(const std::shared_ptr<shield::circuit_breaker>& cb) const;
+    void on_retry(const std::shared_ptr<shield::circuit_breaker>& cb, std::chrono::milliseconds delay) const;
+
+    void on_success(pinned_registration registration, std::optional<std::chrono::nanoseconds> latency = std::nullopt, std::string_view key = {}) const;
+    void on_failure(pinned_registration registration, const std::type_info* exceptionType = nullptr, std::string_view key = {}) const;
+    bool on_execute_function(pinned_registration registration) const;
+    void on_retry(pinned_registration registration, std::chrono::milliseconds delay) const;
+
+    std::vector<std::pair<std::string, std::shared_ptr<event_ring>>> get_event_rings() const;
+
+    // Hands every current and future breaker the slot returned for its name, until detached
+    void attach_stats(std::function<stats_slot*(const std::string&)> slotFor);
+    void detach_stats();
 
-    void register_circuit_breaker(std::shared_ptr<shield::circuit_breaker> circuitBreaker);
+    void register_circuit_breaker(const std::shared_ptr<shield::circuit_breaker>& circuitBreaker);
 
 private:
     std::unique_ptr<detail::impl::circuit_breaker_manager> pImpl;
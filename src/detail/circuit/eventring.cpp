@@ -0,0 +1,144 @@
+#include <detail/circuit/eventring.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <thread>
+
+namespace
+{
+    constexpr std::size_t exceptionTableSize = 256;
+    constexpr std::size_t maxStripes = 16;
+
+    std::array<std::atomic<const std::type_info*>, exceptionTableSize> exceptionTable{};
+
+    std::atomic<std::size_t> nextStripe{ 0 };
+
+    std::size_t stripe_count()
+    {
+        const std::size_t cpus = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        return std::bit_ceil(std::min(cpus, maxStripes));
+    }
+}
+
+namespace shield
+{
+namespace detail
+{
+event_ring::stripe::stripe(std::size_t capacity)
+    : head(0)
+    , slots(std::make_unique<std::atomic<std::uint64_t>[]>(capacity))
+{
+}
+
+event_ring::event_ring(std::size_t capacity)
+    : mask(std::bit_ceil(capacity < 2 ? std::size_t(2) : capacity) - 1)
+    , stripeMask(stripe_count() - 1)
+    , stripes(std::make_unique<std::atomic<stripe*>[]>(stripeMask + 1))
+{
+}
+
+event_ring::~event_ring()
+{
+    for (std::size_t i = 0; i <= stripeMask; ++i)
+    {
+        delete stripes[i].load(std::memory_order_relaxed);
+    }
+}
+
+std::size_t event_ring::stripe_index()
+{
+    // Threads are spread round robin over the stripes in the order they first record
+    thread_local const std::size_t index = nextStripe.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+event_ring::stripe* event_ring::allocate_stripe(std::size_t index)
+{
+    stripe* expected = nullptr;
+    stripe* created = new stripe(mask + 1);
+    if (!stripes[index].compare_exchange_strong(expected, created, std::memory_order_acq_rel))
+    {
+        // Another thread on the same stripe got there first
+        delete created;
+        return expected;
+    }
+
+    return created;
+}
+
+std::vector<std::uint64_t> event_ring::snapshot() const
+{
+    std::vector<std::uint64_t> events;
+    for (std::size_t s = 0; s <= stripeMask; ++s)
+    {
+        const stripe* current = stripes[s].load(std::memory_order_acquire);
+        if (current == nullptr)
+        {
+            continue;
+        }
+
+        const std::uint64_t end = current->head.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > mask + 1 ? end - (mask + 1) : 0;
+        for (std::uint64_t i = begin; i < end; ++i)
+        {
+            const std::uint64_t event = current->slots[i & mask].load(std::memory_order_relaxed);
+            if (event != 0)
+            {
+                events.push_back(event);
+            }
+        }
+    }
+
+    // Merge the stripes by age, which unlike the truncated timestamp itself orders correctly across a
+    // wrap. The sort is stable, so each stripe keeps its own order within a millisecond.
+    const std::uint32_t nowMillis = static_cast<std::uint32_t>(encode(0, 0, monotonic_clock::now()));
+    std::stable_sort(events.begin(), events.end(), [nowMillis](std::uint64_t lhs, std::uint64_t rhs)
+    {
+        return static_cast<std::uint32_t>(nowMillis - static_cast<std::uint32_t>(lhs)) > static_cast<std::uint32_t>(nowMillis - static_cast<std::uint32_t>(rhs));
+    });
+
+    return events;
+}
+
+std::uint32_t exception_types::index_of(const std::type_info* type)
+{
+    if (type == nullptr)
+    {
+        return 0;
+    }
+
+    // Open addressing on the type's hash; slot 0 is reserved for "unknown"
+    const std::size_t start = type->hash_code() % (exceptionTableSize - 1) + 1;
+    for (std::size_t probe = 0; probe < exceptionTableSize - 1; ++probe)
+    {
+        const std::size_t slot = (start - 1 + probe) % (exceptionTableSize - 1) + 1;
+        const std::type_info* existing = exceptionTable[slot].load(std::memory_order_acquire);
+        if (existing == nullptr && exceptionTable[slot].compare_exchange_strong(existing, type, std::memory_order_acq_rel))
+        {
+            return static_cast<std::uint32_t>(slot);
+        }
+        if (existing != nullptr && *existing == *type)
+        {
+            return static_cast<std::uint32_t>(slot);
+        }
+    }
+
+    return 0;
+}
+
+std::vector<std::string> exception_types::names()
+{
+    std::vector<std::string> result(exceptionTableSize);
+    for (std::size_t slot = 1; slot < exceptionTableSize; ++slot)
+    {
+        const std::type_info* type = exceptionTable[slot].load(std::memory_order_acquire);
+        if (type != nullptr)
+        {
+            result[slot] = type->name();
+        }
+    }
+    return result;
+}
+} // detail
+} // shield
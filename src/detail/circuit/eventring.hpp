@@ -0,0 +1,92 @@
+#pragma once
+
+#include <shield/clock.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace shield
+{
+namespace detail
+{
+// Fixed-size, overwrite-oldest ring of breaker events. Each event is packed into one 64 bit word so that
+// recording is a relaxed fetch_add to claim a slot followed by a single relaxed store, and a concurrent
+// reader can never observe a torn event.
+//
+// The ring is striped: each thread records into the stripe picked by its thread-local stripe index, so
+// threads on different stripes never share a cache line. Stripes of capacity() events are allocated on first
+// use and merged by timestamp when a snapshot is taken.
+//
+// Layout: bits 63-56 event type, 55-32 payload, 31-0 timestamp in milliseconds (shield clock, truncated).
+class event_ring final
+{
+public:
+    static constexpr std::uint32_t maxPayload = (1u << 24) - 1;
+
+    explicit event_ring(std::size_t capacity);
+    ~event_ring();
+
+    event_ring(const event_ring&) = delete;
+    event_ring& operator=(const event_ring&) = delete;
+
+    void record(std::uint8_t type, std::uint32_t payload)
+    {
+        stripe* s = stripes[stripe_index() & stripeMask].load(std::memory_order_acquire);
+        if (s == nullptr)
+        {
+            s = allocate_stripe(stripe_index() & stripeMask);
+        }
+
+        const std::uint64_t index = s->head.fetch_add(1, std::memory_order_relaxed);
+        s->slots[index & mask].store(encode(type, payload, monotonic_clock::now()), std::memory_order_relaxed);
+    }
+
+    // Events oldest first; slots that were never written are skipped
+    std::vector<std::uint64_t> snapshot() const;
+
+    // Events kept per stripe
+    std::size_t capacity() const { return mask + 1; }
+
+    static std::uint64_t encode(std::uint8_t type, std::uint32_t payload, monotonic_clock::time_point when)
+    {
+        const std::uint64_t millis = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()).count());
+        return (std::uint64_t(type) << 56) | (std::uint64_t(payload > maxPayload ? maxPayload : payload) << 32) | (millis & 0xFFFFFFFFull);
+    }
+
+    static std::uint32_t saturate(std::int64_t value)
+    {
+        return value < 0 ? 0 : (value > maxPayload ? maxPayload : static_cast<std::uint32_t>(value));
+    }
+
+private:
+    struct alignas(64) stripe
+    {
+        explicit stripe(std::size_t capacity);
+
+        std::atomic<std::uint64_t> head;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    };
+
+    static std::size_t stripe_index();
+
+    stripe* allocate_stripe(std::size_t index);
+
+    const std::uint64_t mask;
+    const std::size_t stripeMask;
+    std::unique_ptr<std::atomic<stripe*>[]> stripes;
+};
+
+// Process-wide table of exception types seen by breakers, so failure events can carry a small index instead
+// of a name. Index 0 means the type was unknown or the table was full.
+class exception_types final
+{
+public:
+    static std::uint32_t index_of(const std::type_info* type);
+    static std::vector<std::string> names();
+};
+} // detail
+} // shield
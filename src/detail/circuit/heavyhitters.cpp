@@ -0,0 +1,109 @@
+#include <detail/circuit/heavyhitters.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace shield
+{
+namespace detail
+{
+heavy_hitters::heavy_hitters(std::size_t capacity)
+    : capacity(std::max(capacity, std::size_t(1)))
+    , slots(std::make_unique<slot[]>(this->capacity))
+{
+}
+
+void heavy_hitters::record(std::string_view key, std::uint64_t weight)
+{
+    const std::uint64_t hash = hash_of(key);
+
+    slot* smallest = &slots[0];
+    std::uint64_t smallestCount = UINT64_MAX;
+    std::uint64_t smallestHash = 0;
+    for (std::size_t i = 0; i < capacity; ++i)
+    {
+        slot& candidate = slots[i];
+        const std::uint64_t candidateHash = candidate.hash.load(std::memory_order_relaxed);
+        if (candidateHash == hash)
+        {
+            candidate.count.fetch_add(weight, std::memory_order_relaxed);
+            return;
+        }
+
+        const std::uint64_t count = candidate.count.load(std::memory_order_relaxed);
+        if (count < smallestCount)
+        {
+            smallest = &candidate;
+            smallestCount = count;
+            smallestHash = candidateHash;
+        }
+    }
+
+    // Take over the smallest entry, expecting the key seen while scanning. Losing the race means another key
+    // claimed it since; dropping this one sample is cheaper than retrying from the hot path.
+    if (!smallest->hash.compare_exchange_strong(smallestHash, hash, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::array<char, keyWords * sizeof(std::uint64_t)> name{};
+    std::memcpy(name.data(), key.data(), std::min(key.size(), maxKeyLength));
+    for (std::size_t i = 0; i < keyWords; ++i)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, name.data() + i * sizeof(std::uint64_t), sizeof(word));
+        smallest->key[i].store(word, std::memory_order_relaxed);
+    }
+
+    smallest->error.store(smallestCount, std::memory_order_relaxed);
+    smallest->count.store(smallestCount + weight, std::memory_order_relaxed);
+}
+
+std::vector<heavy_hitters::entry> heavy_hitters::top() const
+{
+    std::vector<entry> entries;
+    for (std::size_t i = 0; i < capacity; ++i)
+    {
+        const slot& current = slots[i];
+        const std::uint64_t hash = current.hash.load(std::memory_order_relaxed);
+        if (hash == 0)
+        {
+            continue;
+        }
+
+        std::array<char, keyWords * sizeof(std::uint64_t)> name{};
+        for (std::size_t w = 0; w < keyWords; ++w)
+        {
+            const std::uint64_t word = current.key[w].load(std::memory_order_relaxed);
+            std::memcpy(name.data() + w * sizeof(std::uint64_t), &word, sizeof(word));
+        }
+        std::string key(name.data(), ::strnlen(name.data(), name.size()));
+
+        // A key still being written by a takeover does not match its hash yet; truncated keys cannot be checked
+        if (key.size() < maxKeyLength && hash_of(key) != hash)
+        {
+            continue;
+        }
+
+        const auto existing = std::find_if(entries.begin(), entries.end(), [&key](const entry& e) { return e.key == key; });
+        if (existing != entries.end())
+        {
+            existing->count += current.count.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        entries.push_back(entry{ std::move(key), current.count.load(std::memory_order_relaxed), current.error.load(std::memory_order_relaxed) });
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const entry& lhs, const entry& rhs) { return lhs.count > rhs.count; });
+    return entries;
+}
+
+std::uint64_t heavy_hitters::hash_of(std::string_view key)
+{
+    const std::uint64_t hash = static_cast<std::uint64_t>(std::hash<std::string_view>{}(key));
+    return hash == 0 ? 1 : hash;
+}
+} // detail
+} // shield
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace shield
+{
+namespace detail
+{
+// Space-Saving heavy hitters: keeps at most capacity keys, and an untracked key takes over the entry with the
+// smallest count, inheriting that count as its possible overestimate (error). Any key whose true weight is
+// above total / capacity is guaranteed to be tracked.
+//
+// Updates are lock-free: a tracked key is a relaxed fetch_add, taking over an entry is a CAS on its key hash.
+// Racing updates can lose a little weight or briefly track a key twice (merged when read), which is fine for
+// a diagnostic structure. Keys longer than maxKeyLength are reported truncated.
+class heavy_hitters final
+{
+public:
+    static constexpr std::size_t maxKeyLength = 47;
+
+    struct entry
+    {
+        std::string key;
+        std::uint64_t count;
+        std::uint64_t error;
+    };
+
+    explicit heavy_hitters(std::size_t capacity);
+
+    void record(std::string_view key, std::uint64_t weight);
+
+    // Tracked keys, heaviest first
+    std::vector<entry> top() const;
+
+private:
+    static constexpr std::size_t keyWords = (maxKeyLength + 1) / sizeof(std::uint64_t);
+
+    struct slot
+    {
+        std::atomic<std::uint64_t> hash{ 0 }; // Zero when empty
+        std::atomic<std::uint64_t> count{ 0 };
+        std::atomic<std::uint64_t> error{ 0 };
+        std::array<std::atomic<std::uint64_t>, keyWords> key{}; // NUL padded
+    };
+
+    static std::uint64_t hash_of(std::string_view key);
+
+    const std::size_t capacity;
+    std::unique_ptr<slot[]> slots;
+};
+} // detail
+} // shield
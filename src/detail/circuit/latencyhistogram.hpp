@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace shield
+{
+namespace detail
+{
+// Log-linear histogram of latencies in microseconds: four sub-buckets per power of two, so
+// each bucket is at most 25% wide. Anything above the last bucket (~30s) is clamped into it.
+class latency_histogram final
+{
+public:
+    static constexpr std::size_t subBucketBits = 2;
+    static constexpr std::size_t subBucketCount = std::size_t(1) << subBucketBits;
+    static constexpr std::size_t bucketCount = 96;
+
+    void record(std::chrono::nanoseconds latency, std::uint64_t weight = 1)
+    {
+        buckets[index_of(latency)].fetch_add(weight, std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        for (std::atomic<std::uint64_t>& bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds this histogram's counts into a plain array, used to merge the window's buckets
+    void accumulate(std::array<std::uint64_t, bucketCount>& counts) const
+    {
+        for (std::size_t i = 0; i < bucketCount; ++i)
+        {
+            counts[i] += buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    static std::size_t index_of(std::chrono::nanoseconds latency)
+    {
+        const std::int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        if (micros < static_cast<std::int64_t>(subBucketCount))
+        {
+            return micros < 0 ? 0 : static_cast<std::size_t>(micros);
+        }
+
+        const std::uint64_t value = static_cast<std::uint64_t>(micros);
+        const std::size_t exponent = static_cast<std::size_t>(std::bit_width(value)) - 1;
+        const std::size_t sub = static_cast<std::size_t>(value >> (exponent - subBucketBits)) & (subBucketCount - 1);
+        const std::size_t index = (exponent - subBucketBits + 1) * subBucketCount + sub;
+        return index < bucketCount ? index : bucketCount - 1;
+    }
+
+    // Smallest latency that falls in the bucket, used as a conservative value estimate
+    static std::chrono::microseconds lower_bound_of(std::size_t index)
+    {
+        if (index < subBucketCount)
+        {
+            return std::chrono::microseconds(index);
+        }
+
+        const std::size_t exponent = index / subBucketCount + subBucketBits - 1;
+        const std::size_t sub = index % subBucketCount;
+        return std::chrono::microseconds((std::int64_t(1) << exponent) + (std::int64_t(sub) << (exponent - subBucketBits)));
+    }
+
+    // Returns the lower bound of the bucket holding the requested percentile (0.0 - 1.0)
+    static std::chrono::microseconds percentile(const std::array<std::uint64_t, bucketCount>& counts, double percentile)
+    {
+        std::uint64_t total = 0;
+        for (std::uint64_t count : counts)
+        {
+            total += count;
+        }
+
+        if (total == 0)
+        {
+            return std::chrono::microseconds::zero();
+        }
+
+        const double rank = percentile * static_cast<double>(total);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucketCount; ++i)
+        {
+            seen += counts[i];
+            if (static_cast<double>(seen) >= rank && counts[i] != 0)
+            {
+                return lower_bound_of(i);
+            }
+        }
+
+        return lower_bound_of(bucketCount - 1);
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+};
+} // detail
+} // shield
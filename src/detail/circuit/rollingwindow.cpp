@@ -0,0 +1,105 @@
+#include <detail/circuit/rollingwindow.hpp>
+
+#include <algorithm>
+
+namespace shield
+{
+namespace detail
+{
+rolling_window::rolling_window(std::chrono::milliseconds duration, int bucketCount, bool trackLatency)
+    : bucketCount(static_cast<std::size_t>(std::max(bucketCount, 1)))
+    , bucketWidth(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / std::max(bucketCount, 1), 1))
+    , buckets(std::make_unique<bucket[]>(this->bucketCount))
+    , latencies(trackLatency ? std::make_unique<latency_histogram[]>(this->bucketCount) : nullptr)
+{
+}
+
+bool rolling_window::record_success(monotonic_clock::time_point now, std::optional<std::chrono::nanoseconds> latency, std::uint64_t weight)
+{
+    bool rotated = false;
+    const std::size_t index = acquire(now, rotated);
+
+    buckets[index].successes.fetch_add(weight, std::memory_order_relaxed);
+    if (latencies && latency.has_value())
+    {
+        latencies[index].record(*latency, weight);
+    }
+
+    return rotated;
+}
+
+bool rolling_window::record_failure(monotonic_clock::time_point now, std::uint64_t weight)
+{
+    bool rotated = false;
+    const std::size_t index = acquire(now, rotated);
+
+    buckets[index].failures.fetch_add(weight, std::memory_order_relaxed);
+
+    return rotated;
+}
+
+rolling_window::snapshot rolling_window::get_snapshot(monotonic_clock::time_point now) const
+{
+    snapshot result;
+
+    const std::int64_t current = epoch_of(now);
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        const std::int64_t epoch = buckets[i].epoch.load(std::memory_order_acquire);
+        if (epoch < 0 || current - epoch >= static_cast<std::int64_t>(bucketCount))
+        {
+            continue; // Bucket has aged out of the window
+        }
+
+        result.successes += buckets[i].successes.load(std::memory_order_relaxed);
+        result.failures += buckets[i].failures.load(std::memory_order_relaxed);
+        if (latencies)
+        {
+            latencies[i].accumulate(result.latencies);
+        }
+    }
+
+    return result;
+}
+
+void rolling_window::reset()
+{
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        buckets[i].epoch.store(-1, std::memory_order_release);
+        buckets[i].successes.store(0, std::memory_order_relaxed);
+        buckets[i].failures.store(0, std::memory_order_relaxed);
+        if (latencies)
+        {
+            latencies[i].reset();
+        }
+    }
+}
+
+std::int64_t rolling_window::epoch_of(monotonic_clock::time_point now) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() / bucketWidth;
+}
+
+std::size_t rolling_window::acquire(monotonic_clock::time_point now, bool& rotated)
+{
+    const std::int64_t epoch = epoch_of(now);
+    const std::size_t index = static_cast<std::size_t>(epoch % static_cast<std::int64_t>(bucketCount));
+
+    bucket& current = buckets[index];
+    std::int64_t seen = current.epoch.load(std::memory_order_acquire);
+    if (seen < epoch && current.epoch.compare_exchange_strong(seen, epoch, std::memory_order_acq_rel))
+    {
+        current.successes.store(0, std::memory_order_relaxed);
+        current.failures.store(0, std::memory_order_relaxed);
+        if (latencies)
+        {
+            latencies[index].reset();
+        }
+        rotated = true;
+    }
+
+    return index;
+}
+} // detail
+} // shield
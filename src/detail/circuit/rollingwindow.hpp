@@ -0,0 +1,61 @@
+#pragma once
+
+#include <shield/clock.hpp>
+
+#include <detail/circuit/latencyhistogram.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace shield
+{
+namespace detail
+{
+// Time-bucketed window of call outcomes. The window is split into a fixed number of buckets that
+// are recycled as time moves on; whichever caller first lands in a recycled bucket resets it.
+// Counters are relaxed atomics: a record racing with a reset may be lost, which is acceptable for
+// the statistics the breaker derives from the window.
+class rolling_window final
+{
+public:
+    struct snapshot
+    {
+        std::uint64_t successes = 0;
+        std::uint64_t failures = 0;
+        std::array<std::uint64_t, latency_histogram::bucketCount> latencies{};
+    };
+
+    rolling_window(std::chrono::milliseconds duration, int bucketCount, bool trackLatency);
+
+    // Each record function returns true when it rotated into a fresh bucket
+    bool record_success(monotonic_clock::time_point now, std::optional<std::chrono::nanoseconds> latency, std::uint64_t weight = 1);
+    bool record_failure(monotonic_clock::time_point now, std::uint64_t weight = 1);
+
+    snapshot get_snapshot(monotonic_clock::time_point now) const;
+    void reset();
+
+    bool tracks_latency() const { return latencies != nullptr; }
+
+private:
+    struct bucket
+    {
+        std::atomic<std::int64_t> epoch{ -1 };
+        std::atomic<std::uint64_t> successes{ 0 };
+        std::atomic<std::uint64_t> failures{ 0 };
+    };
+
+    std::int64_t epoch_of(monotonic_clock::time_point now) const;
+    std::size_t acquire(monotonic_clock::time_point now, bool& rotated);
+
+private:
+    const std::size_t bucketCount;
+    const std::int64_t bucketWidth;
+    std::unique_ptr<bucket[]> buckets;
+    std::unique_ptr<latency_histogram[]> latencies;
+};
+} // detail
+} // shield
@@ -0,0 +1,44 @@
+#include <detail/circuit/statecache.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace
+{
+    struct cache_entry
+    {
+        const void* breaker = nullptr;
+        std::uint64_t epoch = 0;
+    };
+
+    constexpr std::size_t cacheSize = 16;
+
+    thread_local std::array<cache_entry, cacheSize> entries{};
+
+    std::size_t slot_of(const void* breaker)
+    {
+        // Breakers are heap allocated so the low bits carry little information
+        return (reinterpret_cast<std::uintptr_t>(breaker) >> 6) % cacheSize;
+    }
+}
+
+namespace shield
+{
+namespace detail
+{
+alignas(64) std::atomic<std::uint64_t> state_epoch::value{ 1 };
+
+bool admission_cache::is_closed(const void* breaker, std::uint64_t epoch)
+{
+    const cache_entry& entry = entries[slot_of(breaker)];
+    return entry.breaker == breaker && entry.epoch == epoch;
+}
+
+void admission_cache::set_closed(const void* breaker, std::uint64_t epoch)
+{
+    cache_entry& entry = entries[slot_of(breaker)];
+    entry.breaker = breaker;
+    entry.epoch = epoch;
+}
+} // detail
+} // shield
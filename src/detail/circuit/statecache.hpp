@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace shield
+{
+namespace detail
+{
+// Global counter advanced whenever any breaker changes state (or breakers are added or removed).
+// It sits alone on its cache line so that, between transitions, every core keeps it shared read-only.
+class state_epoch final
+{
+public:
+    static std::uint64_t current() { return value.load(std::memory_order_acquire); }
+    static void advance() { value.fetch_add(1, std::memory_order_release); }
+
+private:
+    alignas(64) static std::atomic<std::uint64_t> value;
+};
+
+// Per-thread, direct-mapped cache of breakers that were closed as of a given epoch. A hit means the breaker
+// is still closed, letting admission skip the manager's lock and lookup entirely.
+class admission_cache final
+{
+public:
+    static bool is_closed(const void* breaker, std::uint64_t epoch);
+    static void set_closed(const void* breaker, std::uint64_t epoch);
+};
+} // detail
+} // shield
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <shield/executormetrics.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace shield
+{
+namespace detail
+{
+// Binary layout of the stats segment shared with other processes (see shield::stats_segment). Every field a
+// live reader may see change is a lock-free atomic, so it is address-free and safe to map in two processes.
+// Any change to these structures must bump statsVersion.
+//
+// The counters of a slot are split over statsLanes lanes, each a full table of stats_counters after the slots.
+// A thread claims a lane of its own the first time it writes, and being its only writer adds with a plain
+// relaxed load and store. Lane 0 is shared by the threads that found every other lane taken, and is added to
+// with fetch_add. Readers sum a slot's counters over every lane.
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free);
+
+constexpr char statsMagic[4] = { 'S', 'H', 'S', 'T' };
+constexpr std::uint32_t statsVersion = 3;
+constexpr std::uint32_t statsLanes = 32;
+constexpr std::uint32_t sharedStatsLane = 0;
+
+struct alignas(64) stats_header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t slotSize;
+    std::uint32_t slotCapacity;
+    std::uint32_t pid;
+    std::uint64_t createdAt; // Milliseconds since the unix epoch
+    std::atomic<std::uint32_t> slotCount; // Stored with release once a new slot's name is written
+    std::uint32_t laneCount;
+    std::uint64_t countersOffset; // From the start of the file to lane 0
+};
+
+enum class stats_kind : std::uint32_t
+{
+    breaker = 1,
+    executor = 2,
+};
+
+// One per breaker or named executor, never reused. Counters are cumulative since the segment was opened.
+struct alignas(64) stats_slot
+{
+    static constexpr std::size_t nameLength = 64;
+
+    char name[nameLength]; // NUL terminated, truncated if longer
+    stats_kind kind;
+    std::uint32_t reserved;
+    std::atomic<std::uint32_t> state; // Breakers only
+    std::atomic<std::uint32_t> failureCount;
+    std::atomic<std::uint64_t> transitions;
+    std::atomic<std::uint64_t> lastTransitionAt; // Milliseconds since the unix epoch, zero if never
+    std::uint64_t capacity; // Executors only
+    std::uint64_t countersOffset; // From this slot to its counters in lane 0
+    std::uint64_t laneStride; // Between the slot's counters in consecutive lanes
+    std::uint64_t padding;
+};
+
+// A slot's counters in one lane, indexed by breaker_counter or executor_counter
+struct alignas(64) stats_counters
+{
+    static constexpr std::size_t count = 8;
+
+    std::atomic<std::uint64_t> values[count];
+};
+
+enum class breaker_counter : std::size_t
+{
+    successes,
+    failures,
+    rejections,
+    retries,
+    cancellations,
+};
+
+enum class executor_counter : std::size_t
+{
+    started,
+    finished,
+    queueWaitNanos,
+    executionNanos,
+    rejections, // One per executor_metrics::rejection_reason from here on
+};
+
+static_assert(sizeof(stats_header) == 64 && sizeof(stats_slot) == 128 && sizeof(stats_counters) == 64);
+static_assert(static_cast<std::size_t>(executor_counter::rejections) + shield::executor_metrics::rejectionReasonCount <= stats_counters::count);
+
+// The calling thread's claim on a lane, released when the thread exits so the lane can be reused
+struct stats_lane_claim final
+{
+    stats_lane_claim();
+    ~stats_lane_claim();
+
+    stats_lane_claim(const stats_lane_claim&) = delete;
+    stats_lane_claim& operator=(const stats_lane_claim&) = delete;
+
+    std::uint32_t lane;
+};
+
+inline std::uint32_t stats_lane()
+{
+    thread_local const stats_lane_claim claim;
+    return claim.lane;
+}
+
+inline std::atomic<std::uint64_t>& stats_counter(stats_slot* slot, std::uint32_t lane, std::size_t counter)
+{
+    char* const counters = reinterpret_cast<char*>(slot) + slot->countersOffset + std::size_t(lane) * slot->laneStride;
+    return reinterpret_cast<stats_counters*>(counters)->values[counter];
+}
+
+// Relaxed, since readers only ever want a recent value and nothing else is ordered against these
+inline void stats_add(stats_slot* slot, std::size_t counter, std::uint64_t value)
+{
+    const std::uint32_t lane = stats_lane();
+    std::atomic<std::uint64_t>& cell = stats_counter(slot, lane, counter);
+    if (lane == sharedStatsLane)
+    {
+        cell.fetch_add(value, std::memory_order_relaxed);
+    }
+    else
+    {
+        cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+inline void stats_add(stats_slot* slot, breaker_counter counter, std::uint64_t value = 1)
+{
+    stats_add(slot, static_cast<std::size_t>(counter), value);
+}
+
+inline void stats_add(stats_slot* slot, executor_counter counter, std::uint64_t value = 1)
+{
+    stats_add(slot, static_cast<std::size_t>(counter), value);
+}
+} // detail
+} // shield
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <shield/executormetrics.hpp>
+#include <shield/function.hpp>
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace shield
+{
+namespace detail
+{
+struct stats_slot;
+
+// Every named executor_metrics, for exporters such as the prometheus collectable and the stats segment
+class executor_metrics_registry final
+{
+public:
+    static executor_metrics_registry& get_instance();
+
+    // attach is called with the executor's stats segment slot whenever a segment is opened or closed
+    void add(const shield::executor_metrics* metrics, unique_function<void(stats_slot*)> attach);
+    void remove(const shield::executor_metrics* metrics);
+
+    // Gives every current and future executor a slot from slotFor, until detach_stats()
+    void attach_stats(std::function<stats_slot*(const std::string&, std::size_t)> slotFor);
+    void detach_stats();
+
+    // Calls visit with each registered executor, holding the registry lock so none is destroyed meanwhile
+    template<typename Visit>
+    void for_each(Visit&& visit) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const registration& current : registered)
+        {
+            visit(*current.metrics);
+        }
+    }
+
+private:
+    struct registration
+    {
+        const shield::executor_metrics* metrics;
+        unique_function<void(stats_slot*)> attach;
+    };
+
+    // Requires the mutex
+    void attach_stats(registration& current);
+
+    mutable std::mutex mutex;
+    std::vector<registration> registered;
+    std::function<stats_slot*(const std::string&, std::size_t)> statsSlotFor; // Set while a stats segment is open
+};
+} // detail
+} // shield
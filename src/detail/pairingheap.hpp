@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+namespace shield
+{
+namespace detail
+{
+// Min-heap with O(1) push and amortised O(log n) pop, and no rebalancing on the push path: a pushed value is
+// melded with the root by a single comparison. Pop combines the root's children with the usual two passes.
+// Nodes are allocated from the memory resource given at construction.
+template<typename T, typename Less>
+class pairing_heap final
+{
+public:
+    explicit pairing_heap(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : allocator(resource)
+    {
+    }
+
+    ~pairing_heap()
+    {
+        // Unlinks children onto the sibling chain as it goes, so the teardown needs no recursion
+        node* pending = root;
+        while (pending)
+        {
+            node* current = pending;
+            pending = current->sibling;
+            if (current->child)
+            {
+                node* last = current->child;
+                while (last->sibling)
+                {
+                    last = last->sibling;
+                }
+                last->sibling = pending;
+                pending = current->child;
+            }
+            allocator.delete_object(current);
+        }
+    }
+
+    pairing_heap(const pairing_heap&) = delete;
+    pairing_heap& operator=(const pairing_heap&) = delete;
+
+    void push(T value)
+    {
+        root = meld(root, allocator.template new_object<node>(std::move(value)));
+        ++count;
+    }
+
+    const T& top() const { return root->value; }
+
+    T pop()
+    {
+        node* const old = root;
+        root = merge_pairs(old->child);
+        --count;
+
+        T value = std::move(old->value);
+        allocator.delete_object(old);
+        return value;
+    }
+
+    bool empty() const { return root == nullptr; }
+    std::size_t size() const { return count; }
+
+private:
+    struct node
+    {
+        T value;
+        node* child = nullptr;
+        node* sibling = nullptr;
+    };
+
+    static node* meld(node* lhs, node* rhs)
+    {
+        if (!lhs)
+        {
+            return rhs;
+        }
+        if (!rhs)
+        {
+            return lhs;
+        }
+        if (Less{}(rhs->value, lhs->value))
+        {
+            std::swap(lhs, rhs);
+        }
+        rhs->sibling = lhs->child;
+        lhs->child = rhs;
+        return lhs;
+    }
+
+    // Melds the children in pairs left to right, then folds the pairs together right to left
+    static node* merge_pairs(node* first)
+    {
+        node* paired = nullptr;
+        while (first)
+        {
+            node* const a = first;
+            node* const b = a->sibling;
+            first = b ? b->sibling : nullptr;
+            a->sibling = nullptr;
+            if (b)
+            {
+                b->sibling = nullptr;
+            }
+
+            node* const pair = meld(a, b);
+            pair->sibling = paired;
+            paired = pair;
+        }
+
+        node* result = nullptr;
+        while (paired)
+        {
+            node* const next = paired->sibling;
+            paired->sibling = nullptr;
+            result = meld(result, paired);
+            paired = next;
+        }
+        return result;
+    }
+
+private:
+    std::pmr::polymorphic_allocator<> allocator;
+    node* root = nullptr;
+    std::size_t count = 0;
+};
+} // detail
+} // shield
@@ -0,0 +1,271 @@
+#include <shield/executormetrics.hpp>
+
+#include <detail/circuit/latencyhistogram.hpp>
+#include <detail/circuit/statslayout.hpp>
+#include <detail/executormetricsregistry.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+    // Threads are spread over a fixed set of cells (like a LongAdder) rather than given one each, so an
+    // executor that starts a thread per task, such as the bulkhead's, does not grow without bound
+    constexpr std::size_t cellCount = 8;
+
+    std::size_t thread_cell()
+    {
+        static std::atomic<std::size_t> nextCell{ 0 };
+        thread_local const std::size_t cell = nextCell.fetch_add(1, std::memory_order_relaxed) % cellCount;
+        return cell;
+    }
+
+    // Exported bucket bounds: every power of two from 4us to ~16s
+    constexpr std::size_t firstBoundExponent = 2;
+    constexpr std::size_t lastBoundExponent = 24;
+}
+
+namespace shield
+{
+namespace detail
+{
+    class executor_metrics final
+    {
+    public:
+        executor_metrics(const std::string& name, std::size_t capacity)
+            : name(name)
+            , capacity(capacity)
+        {
+        }
+
+        void record_start(std::chrono::nanoseconds queueWait)
+        {
+            const std::uint64_t nanos = static_cast<std::uint64_t>(std::max<std::int64_t>(queueWait.count(), 0));
+            cell& current = cells[thread_cell()];
+            current.started.fetch_add(1, std::memory_order_relaxed);
+            current.queueWaitNanos.fetch_add(nanos, std::memory_order_relaxed);
+            current.queueWait.record(inclusive(queueWait));
+
+            if (stats_slot* slot = stats.load(std::memory_order_acquire))
+            {
+                stats_add(slot, executor_counter::started);
+                stats_add(slot, executor_counter::queueWaitNanos, nanos);
+            }
+        }
+
+        void record_finish(std::chrono::nanoseconds executionTime)
+        {
+            const std::uint64_t nanos = static_cast<std::uint64_t>(std::max<std::int64_t>(executionTime.count(), 0));
+            cell& current = cells[thread_cell()];
+            current.finished.fetch_add(1, std::memory_order_relaxed);
+            current.executionNanos.fetch_add(nanos, std::memory_order_relaxed);
+            current.execution.record(inclusive(executionTime));
+
+            if (stats_slot* slot = stats.load(std::memory_order_acquire))
+            {
+                stats_add(slot, executor_counter::finished);
+                stats_add(slot, executor_counter::executionNanos, nanos);
+            }
+        }
+
+        void record_rejection(shield::executor_metrics::rejection_reason reason)
+        {
+            cells[thread_cell()].rejections[static_cast<std::size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+
+            if (stats_slot* slot = stats.load(std::memory_order_acquire))
+            {
+                stats_add(slot, static_cast<std::size_t>(executor_counter::rejections) + static_cast<std::size_t>(reason), 1);
+            }
+        }
+
+        // Called by the registry when a stats segment is opened or closed, null stops publishing
+        void attach_stats(stats_slot* slot)
+        {
+            stats.store(slot, std::memory_order_release);
+        }
+
+        shield::executor_metrics::snapshot get_snapshot() const
+        {
+            shield::executor_metrics::snapshot result;
+            result.takenAt = monotonic_clock::now();
+
+            std::array<std::uint64_t, latency_histogram::bucketCount> queueWait{};
+            std::array<std::uint64_t, latency_histogram::bucketCount> execution{};
+            std::uint64_t queueWaitNanos = 0;
+            std::uint64_t executionNanos = 0;
+            for (const cell& current : cells)
+            {
+                result.started += current.started.load(std::memory_order_relaxed);
+                result.finished += current.finished.load(std::memory_order_relaxed);
+                for (std::size_t i = 0; i < shield::executor_metrics::rejectionReasonCount; ++i)
+                {
+                    result.rejections[i] += current.rejections[i].load(std::memory_order_relaxed);
+                }
+                queueWaitNanos += current.queueWaitNanos.load(std::memory_order_relaxed);
+                executionNanos += current.executionNanos.load(std::memory_order_relaxed);
+                current.queueWait.accumulate(queueWait);
+                current.execution.accumulate(execution);
+            }
+
+            result.queueWaitTotal = std::chrono::nanoseconds(queueWaitNanos);
+            result.executionTotal = std::chrono::nanoseconds(executionNanos);
+            result.queueWait = to_cumulative(queueWait);
+            result.execution = to_cumulative(execution);
+            return result;
+        }
+
+        const std::string& get_name() const { return name; }
+        std::size_t get_capacity() const { return capacity; }
+
+    private:
+        struct alignas(64) cell
+        {
+            std::atomic<std::uint64_t> started{ 0 };
+            std::atomic<std::uint64_t> finished{ 0 };
+            std::array<std::atomic<std::uint64_t>, shield::executor_metrics::rejectionReasonCount> rejections{};
+            std::atomic<std::uint64_t> queueWaitNanos{ 0 };
+            std::atomic<std::uint64_t> executionNanos{ 0 };
+            latency_histogram queueWait;
+            latency_histogram execution;
+        };
+
+        // Recorded a nanosecond short, so each bucket holds (lower, upper] rather than [lower, upper) and a
+        // sample of exactly a bound falls below it, as the inclusive prometheus le bound requires
+        static std::chrono::nanoseconds inclusive(std::chrono::nanoseconds latency)
+        {
+            return latency - std::chrono::nanoseconds(1);
+        }
+
+        // The power of two bounds fall exactly on histogram bucket boundaries, so the counts are exact
+        static shield::executor_metrics::histogram to_cumulative(const std::array<std::uint64_t, latency_histogram::bucketCount>& counts)
+        {
+            shield::executor_metrics::histogram result;
+            std::size_t index = 0;
+            std::uint64_t cumulative = 0;
+            for (std::size_t exponent = firstBoundExponent; exponent <= lastBoundExponent; ++exponent)
+            {
+                const std::chrono::microseconds bound(std::int64_t(1) << exponent);
+                const std::size_t end = latency_histogram::index_of(bound);
+                for (; index < end; ++index)
+                {
+                    cumulative += counts[index];
+                }
+                result.emplace_back(bound, cumulative);
+            }
+            return result;
+        }
+
+    private:
+        const std::string name;
+        const std::size_t capacity;
+        std::array<cell, cellCount> cells;
+        std::atomic<stats_slot*> stats{ nullptr }; // Slot in the open stats segment, if any
+    };
+
+executor_metrics_registry& executor_metrics_registry::get_instance()
+{
+    // Never destroyed, so executors with static storage duration can still unregister at exit
+    static executor_metrics_registry* instance = new executor_metrics_registry();
+    return *instance;
+}
+
+void executor_metrics_registry::add(const shield::executor_metrics* metrics, unique_function<void(stats_slot*)> attach)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    registered.push_back(registration{ metrics, std::move(attach) });
+    attach_stats(registered.back());
+}
+
+void executor_metrics_registry::remove(const shield::executor_metrics* metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    registered.erase(std::remove_if(registered.begin(), registered.end(), [metrics](const registration& current) { return current.metrics == metrics; }), registered.end());
+}
+
+void executor_metrics_registry::attach_stats(std::function<stats_slot*(const std::string&, std::size_t)> slotFor)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    statsSlotFor = std::move(slotFor);
+    for (registration& current : registered)
+    {
+        attach_stats(current);
+    }
+}
+
+void executor_metrics_registry::detach_stats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    statsSlotFor = nullptr;
+    for (registration& current : registered)
+    {
+        attach_stats(current);
+    }
+}
+
+void executor_metrics_registry::attach_stats(registration& current)
+{
+    current.attach(statsSlotFor ? statsSlotFor(current.metrics->get_name(), current.metrics->get_capacity()) : nullptr);
+}
+} // detail
+
+executor_metrics::executor_metrics(const std::string& name, std::size_t capacity)
+    : pImpl(std::make_unique<detail::executor_metrics>(name, capacity))
+{
+    if (!name.empty())
+    {
+        detail::executor_metrics_registry::get_instance().add(this, [impl = pImpl.get()](detail::stats_slot* slot) { impl->attach_stats(slot); });
+    }
+}
+
+executor_metrics::~executor_metrics()
+{
+    if (!pImpl->get_name().empty())
+    {
+        detail::executor_metrics_registry::get_instance().remove(this);
+    }
+}
+
+void executor_metrics::record_start(std::chrono::nanoseconds queueWait)
+{
+    pImpl->record_start(queueWait);
+}
+
+void executor_metrics::record_finish(std::chrono::nanoseconds executionTime)
+{
+    pImpl->record_finish(executionTime);
+}
+
+void executor_metrics::record_rejection(rejection_reason reason)
+{
+    pImpl->record_rejection(reason);
+}
+
+executor_metrics::snapshot executor_metrics::get_snapshot() const
+{
+    return pImpl->get_snapshot();
+}
+
+const std::string& executor_metrics::get_name() const
+{
+    return pImpl->get_name();
+}
+
+std::size_t executor_metrics::get_capacity() const
+{
+    return pImpl->get_capacity();
+}
+
+double executor_metrics::utilisation(const snapshot& from, const snapshot& to, std::size_t capacity)
+{
+    const std::chrono::duration<double> interval = to.takenAt - from.takenAt;
+    if (capacity == 0 || interval.count() <= 0.0)
+    {
+        return 0.0;
+    }
+
+    const std::chrono::duration<double> busy = to.executionTotal - from.executionTotal;
+    return std::clamp(busy.count() / (interval.count() * static_cast<double>(capacity)), 0.0, 1.0);
+}
+} // shield
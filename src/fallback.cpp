@@ -1,10 +1,65 @@
 #include <shield/fallback.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
 namespace shield
 {
+namespace detail
+{
+    class memoised_fallback final
+    {
+    public:
+        memoised_fallback(fallback_policy::callable_type compute, std::chrono::milliseconds refreshInterval)
+            : compute(std::move(compute))
+        {
+            refresh();
+            refresher = std::jthread([this, refreshInterval](std::stop_token stop)
+            {
+                std::mutex mutex;
+                std::condition_variable_any wakeup;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!wakeup.wait_for(lock, stop, refreshInterval, [&stop]() { return stop.stop_requested(); }))
+                {
+                    refresh();
+                }
+            });
+        }
+
+        std::shared_ptr<const std::any> load() const
+        {
+            return current.load(std::memory_order_acquire);
+        }
+
+    private:
+        void refresh()
+        {
+            try
+            {
+                current.store(std::make_shared<const std::any>(compute()), std::memory_order_release);
+            }
+            catch (...)
+            {
+                // Keep serving the previous value
+            }
+        }
+
+    private:
+        const fallback_policy::callable_type compute;
+        std::atomic<std::shared_ptr<const std::any>> current;
+        std::jthread refresher; // Declared last so it is stopped and joined before the rest is destroyed
+    };
+} // detail
+
+// Defined once here rather than per translation unit in the header, and constant-initialised
+constinit const fallback_policy default_fallback_policy;
+
 fallback_policy fallback_policy::with_default()
 {
-    return fallback_policy(fallback_type::DEFAULT);
+    return fallback_policy();
 }
 
 fallback_policy fallback_policy::with_callable(callable_type fallback_function)
@@ -21,15 +76,50 @@ fallback_policy fallback_policy::with_throw()
     return fallback_policy(fallback_type::THROW);
 }
 
+fallback_policy fallback_policy::with_memoised(callable_type fallback_function, std::chrono::milliseconds refresh_interval)
+{
+    if (!fallback_function)
+    {
+        throw std::invalid_argument("fallback_function cannot be null");
+    }
+    if (refresh_interval <= std::chrono::milliseconds::zero())
+    {
+        throw std::invalid_argument("refresh_interval must be positive");
+    }
+
+    fallback_policy policy(fallback_type::MEMOISED);
+    policy.memoised = std::make_shared<detail::memoised_fallback>(std::move(fallback_function), refresh_interval);
+    return policy;
+}
+
+const std::shared_ptr<const fallback_policy>& fallback_policy::shared_default()
+{
+    static const std::shared_ptr<const fallback_policy> instance = std::make_shared<const fallback_policy>(default_fallback_policy);
+    return instance;
+}
+
 const std::type_info& fallback_policy::stored_type() const noexcept
 {
     if (fallbackType == fallback_type::SPECIFIC_VALUE && specificValue.has_value())
     {
         return specificValue.type();
     }
+    if (fallbackType == fallback_type::MEMOISED)
+    {
+        const std::shared_ptr<const std::any> value = load_memoised();
+        if (value && value->has_value())
+        {
+            return value->type();
+        }
+    }
     return typeid(void);
 }
 
+std::shared_ptr<const std::any> fallback_policy::load_memoised() const
+{
+    return memoised ? memoised->load() : nullptr;
+}
+
 void fallback_policy::validate() const
 {
     if (fallbackType == fallback_type::SPECIFIC_VALUE && !specificValue.has_value())
@@ -55,6 +145,8 @@ std::string to_string(fallback_type type)
         return "CALLABLE";
     case fallback_type::THROW:
         return "THROW";
+    case fallback_type::MEMOISED:
+        return "MEMOISED";
     default:
         return "UNKNOWN";
     }
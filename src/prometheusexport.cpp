@@ -0,0 +1,82 @@
+#include <shield/executormetrics.hpp>
+
+#include <detail/executormetricsregistry.hpp>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include <limits>
+
+namespace
+{
+    class executor_metrics_collectable final : public prometheus::Collectable
+    {
+    public:
+        std::vector<prometheus::MetricFamily> Collect() const override
+        {
+            prometheus::MetricFamily queueWait{ "shield_executor_queue_wait_seconds", "Time tasks waited before starting", prometheus::MetricType::Histogram, {} };
+            prometheus::MetricFamily execution{ "shield_executor_execution_seconds", "Time tasks took to run", prometheus::MetricType::Histogram, {} };
+            prometheus::MetricFamily busy{ "shield_executor_busy_seconds_total", "Execution time summed over every task", prometheus::MetricType::Counter, {} };
+            prometheus::MetricFamily rejections{ "shield_executor_rejections_total", "Tasks turned away, by reason", prometheus::MetricType::Counter, {} };
+            prometheus::MetricFamily inFlight{ "shield_executor_in_flight", "Tasks currently running", prometheus::MetricType::Gauge, {} };
+            prometheus::MetricFamily capacity{ "shield_executor_capacity", "Maximum concurrent tasks", prometheus::MetricType::Gauge, {} };
+
+            shield::detail::executor_metrics_registry::get_instance().for_each([&](const shield::executor_metrics& metrics)
+            {
+                const shield::executor_metrics::snapshot snapshot = metrics.get_snapshot();
+                const std::vector<prometheus::ClientMetric::Label> labels{ { "executor", metrics.get_name() } };
+
+                queueWait.metric.push_back(to_histogram(labels, snapshot.queueWait, snapshot.started, snapshot.queueWaitTotal));
+                execution.metric.push_back(to_histogram(labels, snapshot.execution, snapshot.finished, snapshot.executionTotal));
+
+                prometheus::ClientMetric& busyMetric = busy.metric.emplace_back();
+                busyMetric.label = labels;
+                busyMetric.counter.value = std::chrono::duration<double>(snapshot.executionTotal).count();
+
+                static constexpr const char* reasons[shield::executor_metrics::rejectionReasonCount] = { "capacity", "timeout", "expired", "cancelled" };
+                for (std::size_t i = 0; i < shield::executor_metrics::rejectionReasonCount; ++i)
+                {
+                    prometheus::ClientMetric& rejectionMetric = rejections.metric.emplace_back();
+                    rejectionMetric.label = labels;
+                    rejectionMetric.label.push_back({ "reason", reasons[i] });
+                    rejectionMetric.counter.value = static_cast<double>(snapshot.rejections[i]);
+                }
+
+                prometheus::ClientMetric& inFlightMetric = inFlight.metric.emplace_back();
+                inFlightMetric.label = labels;
+                inFlightMetric.gauge.value = snapshot.started > snapshot.finished ? static_cast<double>(snapshot.started - snapshot.finished) : 0.0;
+
+                prometheus::ClientMetric& capacityMetric = capacity.metric.emplace_back();
+                capacityMetric.label = labels;
+                capacityMetric.gauge.value = static_cast<double>(metrics.get_capacity());
+            });
+
+            return { std::move(queueWait), std::move(execution), std::move(busy), std::move(rejections), std::move(inFlight), std::move(capacity) };
+        }
+
+    private:
+        static prometheus::ClientMetric to_histogram(const std::vector<prometheus::ClientMetric::Label>& labels, const shield::executor_metrics::histogram& buckets, std::uint64_t count, std::chrono::nanoseconds sum)
+        {
+            prometheus::ClientMetric metric;
+            metric.label = labels;
+            metric.histogram.sample_count = count;
+            metric.histogram.sample_sum = std::chrono::duration<double>(sum).count();
+            for (const auto& [bound, cumulative] : buckets)
+            {
+                metric.histogram.bucket.push_back({ cumulative, std::chrono::duration<double>(bound).count() });
+            }
+            metric.histogram.bucket.push_back({ count, std::numeric_limits<double>::infinity() });
+            return metric;
+        }
+    };
+}
+
+namespace shield
+{
+std::shared_ptr<prometheus::Collectable> executor_metrics::get_prometheus_collectable()
+{
+    // Never destroyed, like the registry it reads
+    static const std::shared_ptr<prometheus::Collectable>* instance = new std::shared_ptr<prometheus::Collectable>(std::make_shared<executor_metrics_collectable>());
+    return *instance;
+}
+} // shield
@@ -1 +1,18 @@
-#include <shield/retry.hpp>
\ No newline at end of file
+#include <shield/retry.hpp>
+
+namespace shield
+{
+namespace
+{
+    constinit const exponential_backoff defaultBackoff(std::chrono::milliseconds(100));
+}
+
+// Defined once here rather than per translation unit in the header, and constant-initialised, so including
+// shield adds no startup work
+constinit const retry_policy default_retry_policy;
+
+const backoff_strategy& retry_policy::default_backoff()
+{
+    return defaultBackoff;
+}
+} // shield
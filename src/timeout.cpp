@@ -1,9 +1,11 @@
-#include <shield/timeout.hpp>
+#include <shield/timeoutexecutor.hpp>
 
 namespace shield
 {
-timeout_executor::timeout_executor() 
-    //: work(ioContext)
+timeout_executor::timeout_executor(const std::string& name, std::size_t threads)
+    : workGuard(boost::asio::make_work_guard(ioContext))
+    , metrics(std::make_shared<executor_metrics>(name, threads))
+    , tasks(threads)
 {
     thread = std::thread([this]()
     {
@@ -13,6 +15,7 @@ timeout_executor::timeout_executor()
 
 timeout_executor::~timeout_executor()
 {
+    workGuard.reset();
     ioContext.stop();
     if (thread.joinable())
     {
@@ -0,0 +1,235 @@
+#include <shield/timerservice.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace shield
+{
+namespace detail
+{
+    class timer_service final
+    {
+    public:
+        explicit timer_service(std::pmr::memory_resource* resource)
+            : timers(resource)
+        {
+#if defined(__linux__)
+            fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "timerfd_create");
+            }
+#endif
+        }
+
+        ~timer_service()
+        {
+#if defined(__linux__)
+            ::close(fd);
+#endif
+        }
+
+        shield::timer_service::timer_id schedule_at(monotonic_clock::time_point when, shield::timer_service::callback func)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const shield::timer_service::timer_id id{ when, ++lastSequence };
+            timers.emplace(id, std::move(func));
+            if (timers.begin()->first == id)
+            {
+                arm();
+            }
+            return id;
+        }
+
+        bool cancel(const shield::timer_service::timer_id& id)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const auto iter = timers.find(id);
+            if (iter == timers.end())
+            {
+                return false;
+            }
+
+            const bool wasFirst = iter == timers.begin();
+            timers.erase(iter);
+            if (wasFirst)
+            {
+                arm();
+            }
+            return true;
+        }
+
+        std::size_t process_expired()
+        {
+            drain();
+
+            // Precise, so a timer the descriptor fired for is not seen as up to a coarse clock tick early
+            const monotonic_clock::time_point now = monotonic_clock::precise_now();
+            std::uint64_t lastDue;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                lastDue = lastSequence;
+            }
+
+            std::size_t run = 0;
+            try
+            {
+                // One at a time with the lock released, so a callback can cancel a timer that is also due
+                while (shield::timer_service::callback func = take_due(now, lastDue))
+                {
+                    func();
+                    ++run;
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                arm();
+                throw;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            arm();
+            return run;
+        }
+
+        int native_handle() const
+        {
+            return fd;
+        }
+
+        std::optional<monotonic_clock::time_point> next_expiry() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return timers.empty() ? std::nullopt : std::optional<monotonic_clock::time_point>(timers.begin()->first.when);
+        }
+
+        std::size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return timers.size();
+        }
+
+    private:
+        shield::timer_service::callback take_due(monotonic_clock::time_point now, std::uint64_t lastDue)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (auto iter = timers.begin(); iter != timers.end() && iter->first.when <= now; ++iter)
+            {
+                if (iter->first.sequence <= lastDue)
+                {
+                    shield::timer_service::callback func = std::move(iter->second);
+                    timers.erase(iter);
+                    return func;
+                }
+            }
+            return nullptr;
+        }
+
+        // Requires the mutex. Real time sources share CLOCK_MONOTONIC's timeline, so the descriptor is armed for
+        // the due time itself; under the manual source it is armed with the simulated delay instead.
+        void arm()
+        {
+#if defined(__linux__)
+            itimerspec spec{};
+            int flags = 0;
+            if (!timers.empty())
+            {
+                const monotonic_clock::time_point when = timers.begin()->first.when;
+                std::chrono::nanoseconds value;
+                if (monotonic_clock::get_source() == monotonic_clock::source::manual)
+                {
+                    value = when - monotonic_clock::now();
+                }
+                else
+                {
+                    value = when.time_since_epoch();
+                    flags = TFD_TIMER_ABSTIME;
+                }
+
+                // A zero value would disarm the descriptor rather than fire it
+                value = std::max(value, std::chrono::nanoseconds(1));
+                spec.it_value.tv_sec = static_cast<time_t>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
+                spec.it_value.tv_nsec = static_cast<long>((value % std::chrono::seconds(1)).count());
+            }
+            ::timerfd_settime(fd, flags, &spec, nullptr);
+#endif
+        }
+
+        // Clears the descriptor's readiness
+        void drain()
+        {
+#if defined(__linux__)
+            std::uint64_t expirations;
+            while (::read(fd, &expirations, sizeof(expirations)) > 0)
+            {
+            }
+#endif
+        }
+
+    private:
+        int fd = -1;
+        mutable std::mutex mutex;
+        std::pmr::map<shield::timer_service::timer_id, shield::timer_service::callback> timers;
+        std::uint64_t lastSequence = 0;
+    };
+} // detail
+
+timer_service::timer_service(std::pmr::memory_resource* resource)
+    : pImpl(std::make_unique<detail::timer_service>(resource))
+{
+}
+
+timer_service::~timer_service()
+{
+}
+
+timer_service::timer_id timer_service::schedule_at(monotonic_clock::time_point when, callback func)
+{
+    return pImpl->schedule_at(when, std::move(func));
+}
+
+timer_service::timer_id timer_service::schedule_after(monotonic_clock::duration delay, callback func)
+{
+    return pImpl->schedule_at(monotonic_clock::precise_now() + delay, std::move(func));
+}
+
+bool timer_service::cancel(const timer_id& id)
+{
+    return pImpl->cancel(id);
+}
+
+std::size_t timer_service::process_expired()
+{
+    return pImpl->process_expired();
+}
+
+int timer_service::native_handle() const
+{
+    return pImpl->native_handle();
+}
+
+std::optional<monotonic_clock::time_point> timer_service::next_expiry() const
+{
+    return pImpl->next_expiry();
+}
+
+std::size_t timer_service::size() const
+{
+    return pImpl->size();
+}
+} // shield
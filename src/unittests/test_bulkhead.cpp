@@ -1,10 +1,14 @@
-// #include <shield/all.hpp>
-// 
-// #include <catch2/catch_test_macros.hpp>
-// #include <catch2/matchers/catch_matchers_exception.hpp>
-// 
-// #include <vector>
-// 
+#include <shield/all.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
 // TEST_CASE("Bulkhead - executes single task", "[bulkhead]")
 // {
 //     shield::bulkhead bh(5);
@@ -203,4 +207,133 @@
 //     
 //     REQUIRE(successful.load() > 0);
 //     REQUIRE(completed == successful.load());
-// }
\ No newline at end of file
+// }
+
+TEST_CASE("Bulkhead - permits are weighted by cost", "[bulkhead][permit]")
+{
+    shield::bulkhead bh(10);
+
+    shield::bulkhead::permit batch = bh.try_acquire(8);
+    REQUIRE(batch);
+    REQUIRE(batch.get_cost() == 8);
+    REQUIRE(bh.get_current_count() == 8);
+
+    REQUIRE_FALSE(bh.try_acquire(3));
+    shield::bulkhead::permit single = bh.try_acquire();
+    REQUIRE(single);
+    REQUIRE(bh.get_current_count() == 9);
+
+    batch.release();
+    REQUIRE_FALSE(batch);
+    REQUIRE(bh.get_current_count() == 1);
+
+    {
+        shield::bulkhead::permit moved = std::move(single);
+        REQUIRE_FALSE(single);
+    }
+    REQUIRE(bh.get_current_count() == 0);
+
+    const shield::executor_metrics::snapshot snapshot = bh.get_metrics().get_snapshot();
+    REQUIRE(snapshot.rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::capacity)] == 1);
+}
+
+TEST_CASE("Bulkhead - blocking acquire times out and refuses oversized costs", "[bulkhead][permit]")
+{
+    shield::bulkhead bh(4);
+
+    REQUIRE_FALSE(bh.acquire(5, std::chrono::seconds(1)));
+
+    shield::bulkhead::permit held = bh.try_acquire(4);
+    REQUIRE_FALSE(bh.acquire(1, std::chrono::milliseconds(20)));
+    REQUIRE(bh.get_waiting_count() == 0);
+
+    const shield::executor_metrics::snapshot snapshot = bh.get_metrics().get_snapshot();
+    REQUIRE(snapshot.rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::timeout)] == 1);
+}
+
+TEST_CASE("Bulkhead - queued large request is not starved by small ones", "[bulkhead][permit]")
+{
+    shield::bulkhead bh(4);
+    shield::bulkhead::permit small = bh.try_acquire(1);
+
+    std::atomic<bool> granted{ false };
+    std::thread large([&bh, &granted]()
+    {
+        shield::bulkhead::permit permit = bh.acquire(4, std::chrono::seconds(5));
+        granted = static_cast<bool>(permit);
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (bh.get_waiting_count() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(bh.get_waiting_count() == 1);
+
+    // There are three free units, but they are held back for the queued request
+    REQUIRE_FALSE(bh.try_acquire(1));
+
+    small.release();
+    large.join();
+    REQUIRE(granted);
+    REQUIRE(bh.get_current_count() == 0);
+}
+
+TEST_CASE("Bulkhead - waiters are granted in arrival order", "[bulkhead][permit]")
+{
+    shield::bulkhead bh(2);
+    shield::bulkhead::permit held = bh.try_acquire(2);
+
+    std::vector<int> order;
+    std::mutex orderMutex;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i)
+    {
+        threads.emplace_back([&bh, &order, &orderMutex, i]()
+        {
+            shield::bulkhead::permit permit = bh.acquire(2, std::chrono::seconds(5));
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(permit ? i : -1);
+        });
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (bh.get_waiting_count() != static_cast<size_t>(i + 1) && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    held.release();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(order == std::vector<int>{ 0, 1, 2 });
+}
+
+TEST_CASE("Bulkhead - cancelled waiter gives up its place", "[bulkhead][permit][cancellation]")
+{
+    shield::bulkhead bh(1);
+    shield::bulkhead::permit held = bh.try_acquire(1);
+
+    std::stop_source cancel;
+    const auto started = std::chrono::steady_clock::now();
+    std::thread waiter([&bh, token = cancel.get_token()]()
+    {
+        shield::cancellation_scope scope(token);
+        REQUIRE_FALSE(bh.acquire(1, std::chrono::seconds(5)));
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (bh.get_waiting_count() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    cancel.request_stop();
+    waiter.join();
+
+    REQUIRE(std::chrono::steady_clock::now() - started < std::chrono::seconds(2));
+    REQUIRE(bh.get_waiting_count() == 0);
+    REQUIRE(bh.get_metrics().get_snapshot().rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::cancelled)] == 1);
+}
@@ -1450,4 +1450,174 @@ TEST_CASE_METHOD(circuit_test_fixture, "Circuit with retry policy - respects cir
         .run<std::runtime_error>([]() { return 42; }),
         "Circuit is OPEN and no fallback value could be obtained."
     );
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit with retry policy - falls back at once when the breaker cannot reopen in time", "[circuit][retry_policy]")
+{
+    const std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("open-mid-retry", 2, std::chrono::seconds(10));
+
+    shield::retry_policy policy = shield::retry_policy()
+        .with_max_attempts(5)
+        .with_fixed_backoff(std::chrono::milliseconds(200));
+
+    int call_count = 0;
+    const auto started = std::chrono::steady_clock::now();
+    const int result = shield::circuit(cb)
+        .with_retry_policy(policy)
+        .with_fallback_policy(shield::fallback_policy::with_value(7))
+        .run<std::runtime_error>([&call_count]() -> int
+        {
+            ++call_count;
+            throw std::runtime_error("Fail");
+        });
+
+    // The breaker opened on the second failure and the remaining backoff never reaches its reset timeout, so
+    // only the sleep ahead of the second attempt was taken
+    REQUIRE(result == 7);
+    REQUIRE(call_count == 2);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    REQUIRE(std::chrono::steady_clock::now() - started < std::chrono::milliseconds(400));
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit with retry policy - skips attempts the open breaker would reject", "[circuit][retry_policy]")
+{
+    const std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("skip-rejected", 1, std::chrono::milliseconds(50));
+
+    std::vector<int> retry_attempts;
+    shield::retry_policy policy = shield::retry_policy()
+        .with_max_attempts(6)
+        .with_fixed_backoff(std::chrono::milliseconds(20))
+        .on_retry([&retry_attempts](const std::exception&, int attempt, std::chrono::milliseconds) { retry_attempts.push_back(attempt); });
+
+    int call_count = 0;
+    const int result = shield::circuit(cb)
+        .with_retry_policy(policy)
+        .run<std::runtime_error>([&call_count]()
+        {
+            if (++call_count == 1)
+            {
+                throw std::runtime_error("Fail once");
+            }
+            return 42;
+        });
+
+    // Attempts 2 and 3 would have landed while the breaker was still open
+    REQUIRE(result == 42);
+    REQUIRE(call_count == 2);
+    REQUIRE(retry_attempts == std::vector<int>{ 3 });
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+// ============================================================================
+// SHARED POLICIES AND CALL SITE CIRCUITS
+// ============================================================================
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - circuits share policies instead of copying them", "[circuit][policy]")
+{
+    const std::shared_ptr<const shield::retry_policy> retry = std::make_shared<const shield::retry_policy>(shield::retry_policy(2).with_fixed_backoff(std::chrono::milliseconds(1)));
+    const std::shared_ptr<const shield::fallback_policy> fallback = std::make_shared<const shield::fallback_policy>(shield::fallback_policy::with_value(7));
+
+    const shield::circuit first("shared-policy-first", retry, fallback);
+    const shield::circuit second("shared-policy-second", retry, fallback);
+    const shield::circuit copy = first;
+    REQUIRE(retry.use_count() == 4);
+    REQUIRE(fallback.use_count() == 4);
+
+    // The fallback reaches the retry policy without being baked into it
+    REQUIRE(first.run([]() -> int { throw std::runtime_error("Fail"); }) == 7);
+    REQUIRE(second.run([]() { return 3; }) == 3);
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - static run shares the default policies", "[circuit][policy]")
+{
+    REQUIRE(shield::retry_policy::shared_default() == shield::retry_policy::shared_default());
+    REQUIRE(shield::fallback_policy::shared_default() == shield::fallback_policy::shared_default());
+    REQUIRE(shield::circuit::run([]() { return 3; }, "static-default") == 3);
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - call site circuit is built once", "[circuit][policy]")
+{
+    const shield::circuit* previous = nullptr;
+    for (int i = 0; i < 3; ++i)
+    {
+        const shield::circuit& cached = SHIELD_CIRCUIT("callsite-cached", shield::retry_policy(1));
+        REQUIRE((previous == nullptr || previous == &cached));
+        previous = &cached;
+
+        REQUIRE(cached.run([i]() { return i; }) == i);
+    }
+
+    REQUIRE(shield::detail::circuit_breaker_manager::get_instance().get("callsite-cached") != nullptr);
+
+    // Pinned, so it is still the registered breaker after a clear
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+    REQUIRE(shield::detail::circuit_breaker_manager::get_instance().get("callsite-cached") == previous->get_circuit_breaker());
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - static run resolves the breaker again after a clear", "[circuit][policy]")
+{
+    const auto call = []() { return shield::circuit::run([]() -> int { throw std::runtime_error("Fail"); }, "static-resolved", shield::retry_policy(1), shield::default_timeout_policy, shield::fallback_policy::with_value(5)); };
+
+    REQUIRE(call() == 5);
+    std::shared_ptr<shield::circuit_breaker> first = shield::detail::circuit_breaker_manager::get_instance().get("static-resolved");
+    REQUIRE(first->get_failure_count() == 1);
+
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+    REQUIRE(call() == 5);
+    std::shared_ptr<shield::circuit_breaker> second = shield::detail::circuit_breaker_manager::get_instance().get("static-resolved");
+    REQUIRE(second != first);
+    REQUIRE(second->get_failure_count() == 1);
+}
+
+// ============================================================================
+// STATIC BREAKERS
+// ============================================================================
+
+namespace
+{
+    shield::circuit_breaker::config static_breaker_config()
+    {
+        shield::circuit_breaker::config cfg;
+        cfg.failureThreshold = 2;
+        cfg.timeout = std::chrono::seconds(10);
+        return cfg;
+    }
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - static breaker is registered before first use", "[circuit][static]")
+{
+    using breaker = shield::static_breaker<"static-registered">;
+
+    // Registered during static initialisation, and kept by the registry clear between tests
+    REQUIRE(shield::detail::circuit_breaker_manager::get_instance().get("static-registered") != nullptr);
+    REQUIRE(breaker::name == "static-registered");
+    REQUIRE(breaker::run([]() { return 11; }) == 11);
+    REQUIRE(&breaker::get() == shield::detail::circuit_breaker_manager::get_instance().get("static-registered").get());
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - static breaker uses its configuration", "[circuit][static]")
+{
+    using breaker = shield::static_breaker<"static-configured", &static_breaker_config>;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        REQUIRE_THROWS_AS(breaker::run([]() -> int { throw std::runtime_error("Fail"); }), std::runtime_error);
+    }
+
+    REQUIRE(breaker::get().get_state() == shield::circuit_breaker::state::open);
+    REQUIRE(breaker::get().get_name() == "static-configured");
+    REQUIRE_THROWS_AS(breaker::run([]() { return 1; }), shield::open_circuit_exception);
+}
+
+TEST_CASE_METHOD(circuit_test_fixture, "Circuit - clearing the registry keeps pinned breakers", "[circuit][static]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "pinned-kept";
+    const shield::circuit pinned = shield::circuit::pinned(cfg);
+    shield::circuit_breaker::create("pinned-dropped", 5, std::chrono::seconds(10));
+
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+
+    REQUIRE(shield::detail::circuit_breaker_manager::get_instance().get("pinned-kept") == pinned.get_circuit_breaker());
+    REQUIRE(shield::detail::circuit_breaker_manager::get_instance().get("pinned-dropped") == nullptr);
+    REQUIRE(pinned.run([]() { return 2; }) == 2);
+}
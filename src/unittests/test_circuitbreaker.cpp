@@ -1,11 +1,16 @@
 #include <shield/all.hpp>
 
 #include <detail/circuit/circuitbreakermanager.hpp>
+#include <detail/circuit/heavyhitters.hpp>
+#include <detail/circuit/latencyhistogram.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_exception.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 struct circuit_breaker_test_fixture
 {
@@ -15,6 +20,9 @@ public:
         shield::detail::circuit_breaker_manager::get_instance().clear();
     }
 
+    void record_failure(std::shared_ptr<shield::circuit_breaker> cb) { on_failure(cb); }
+    void record_success(std::shared_ptr<shield::circuit_breaker> cb) { on_success(cb); }
+
 protected:
     bool on_execute_function(std::shared_ptr<shield::circuit_breaker> cb)
     {
@@ -26,9 +34,9 @@ protected:
         shield::detail::circuit_breaker_manager::get_instance().on_failure(cb);
     }
 
-    void on_success(std::shared_ptr<shield::circuit_breaker> cb)
+    void on_success(std::shared_ptr<shield::circuit_breaker> cb, std::optional<std::chrono::nanoseconds> latency = std::nullopt)
     {
-        shield::detail::circuit_breaker_manager::get_instance().on_success(cb);
+        shield::detail::circuit_breaker_manager::get_instance().on_success(cb, latency);
     }
 };
 
@@ -452,4 +460,538 @@ TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - custom failure
     on_failure(cb);
     
     REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// LATENCY TRIPPING TESTS
+// ============================================================================
+
+TEST_CASE("Latency histogram - bucket bounds and percentile", "[circuit_breaker][latency]")
+{
+    using shield::detail::latency_histogram;
+
+    // Every bucket's lower bound must map back to that bucket
+    for (std::size_t i = 0; i < latency_histogram::bucketCount; ++i)
+    {
+        REQUIRE(latency_histogram::index_of(latency_histogram::lower_bound_of(i)) == i);
+    }
+
+    std::array<std::uint64_t, latency_histogram::bucketCount> counts{};
+    for (int i = 0; i < 99; ++i)
+    {
+        counts[latency_histogram::index_of(std::chrono::microseconds(100))]++;
+    }
+    counts[latency_histogram::index_of(std::chrono::milliseconds(500))]++;
+
+    REQUIRE(latency_histogram::percentile(counts, 0.50) <= std::chrono::microseconds(100));
+    REQUIRE(latency_histogram::percentile(counts, 0.99) <= std::chrono::microseconds(100));
+    REQUIRE(latency_histogram::percentile(counts, 1.0) > std::chrono::milliseconds(400));
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - latency tripping disabled by default", "[circuit_breaker][latency]")
+{
+    shield::circuit_breaker::config cfg;
+    REQUIRE(cfg.latencyThreshold == std::chrono::milliseconds::zero());
+    REQUIRE(cfg.latencyPercentile == 0.99);
+    REQUIRE(cfg.windowDuration == std::chrono::milliseconds(std::chrono::seconds(10)));
+    REQUIRE(cfg.windowBuckets == 10);
+
+    cfg.name = "latency-disabled";
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        on_success(cb, std::chrono::seconds(5));
+    }
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - opens when p99 latency exceeds threshold", "[circuit_breaker][latency]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "latency-trip";
+    cfg.latencyThreshold = std::chrono::milliseconds(100);
+    cfg.windowDuration = std::chrono::milliseconds(200);
+    cfg.windowBuckets = 10;
+    cfg.minimumCalls = 20;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        on_success(cb, std::chrono::milliseconds(250));
+    }
+
+    // The window is evaluated when the next bucket is entered
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    on_success(cb, std::chrono::milliseconds(250));
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    REQUIRE(on_execute_function(cb) == false);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - stays closed when p99 latency is under threshold", "[circuit_breaker][latency]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "latency-healthy";
+    cfg.latencyThreshold = std::chrono::milliseconds(100);
+    cfg.windowDuration = std::chrono::milliseconds(200);
+    cfg.minimumCalls = 20;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    // A single slow outlier is below the 99th percentile
+    on_success(cb, std::chrono::milliseconds(500));
+    for (int i = 0; i < 200; ++i)
+    {
+        on_success(cb, std::chrono::milliseconds(5));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    on_success(cb, std::chrono::milliseconds(5));
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - latency tripping requires minimum calls", "[circuit_breaker][latency]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "latency-minimum";
+    cfg.latencyThreshold = std::chrono::milliseconds(100);
+    cfg.windowDuration = std::chrono::milliseconds(200);
+    cfg.minimumCalls = 50;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        on_success(cb, std::chrono::seconds(1));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    on_success(cb, std::chrono::seconds(1));
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+// ============================================================================
+// ADAPTIVE THRESHOLD TESTS
+// ============================================================================
+
+namespace
+{
+    // Drives the breaker through several window buckets with one failure every failureEvery calls
+    void run_at_error_rate(circuit_breaker_test_fixture& fixture, std::shared_ptr<shield::circuit_breaker> cb, int failureEvery, int buckets)
+    {
+        for (int bucket = 0; bucket < buckets; ++bucket)
+        {
+            for (int i = 1; i <= 50; ++i)
+            {
+                if (i % failureEvery == 0)
+                {
+                    fixture.record_failure(cb);
+                }
+                else
+                {
+                    fixture.record_success(cb);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(12));
+        }
+    }
+
+    shield::circuit_breaker::config adaptive_config(const std::string& name)
+    {
+        shield::circuit_breaker::config cfg;
+        cfg.name = name;
+        cfg.adaptiveThreshold = true;
+        cfg.windowDuration = std::chrono::milliseconds(100);
+        cfg.windowBuckets = 10;
+        cfg.minimumCalls = 20;
+        return cfg;
+    }
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - adaptive threshold learns baseline error rate", "[circuit_breaker][adaptive]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(adaptive_config("adaptive-learn"));
+    REQUIRE_FALSE(cb->get_baseline_error_rate().has_value());
+
+    run_at_error_rate(*this, cb, 50, 15);
+
+    REQUIRE(cb->get_baseline_error_rate().has_value());
+    REQUIRE(cb->get_baseline_error_rate().value() > 0.005);
+    REQUIRE(cb->get_baseline_error_rate().value() < 0.05);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - adaptive threshold waits a full window before learning", "[circuit_breaker][adaptive]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(adaptive_config("adaptive-full-window"));
+
+    // Well over minimumCalls, but only two of the window's ten buckets have been seen
+    for (int i = 0; i < 100; ++i)
+    {
+        record_success(cb);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    record_success(cb);
+    REQUIRE_FALSE(cb->get_baseline_error_rate().has_value());
+
+    run_at_error_rate(*this, cb, 50, 15);
+    REQUIRE(cb->get_baseline_error_rate().has_value());
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - adaptive threshold tolerates errors at baseline rate", "[circuit_breaker][adaptive]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(adaptive_config("adaptive-tolerate"));
+
+    // A dependency that normally fails one call in ten
+    run_at_error_rate(*this, cb, 10, 25);
+
+    REQUIRE(cb->get_baseline_error_rate().has_value());
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - adaptive threshold opens on deviation from baseline", "[circuit_breaker][adaptive]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(adaptive_config("adaptive-deviation"));
+
+    run_at_error_rate(*this, cb, 50, 15);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        on_failure(cb);
+    }
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - adaptive threshold uses failure threshold until baseline is learned", "[circuit_breaker][adaptive]")
+{
+    shield::circuit_breaker::config cfg = adaptive_config("adaptive-warmup");
+    cfg.failureThreshold = 3;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        on_failure(cb);
+    }
+
+    REQUIRE_FALSE(cb->get_baseline_error_rate().has_value());
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+// ============================================================================
+// OUTCOME SAMPLING TESTS
+// ============================================================================
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - sampled successes are weighted", "[circuit_breaker][sampling]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "sampled-latency";
+    cfg.latencyThreshold = std::chrono::milliseconds(100);
+    cfg.windowDuration = std::chrono::seconds(1);
+    cfg.minimumCalls = 500;
+    cfg.successSampleRate = 10;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    // Roughly 100 of these are recorded, each counting for 10 calls
+    for (int i = 0; i < 1000; ++i)
+    {
+        on_success(cb, std::chrono::milliseconds(250));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    for (int i = 0; i < 100 && cb->get_state() == shield::circuit_breaker::state::closed; ++i)
+    {
+        on_success(cb, std::chrono::milliseconds(250));
+    }
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - sampling never skips failures or resets", "[circuit_breaker][sampling]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "sampled-failures";
+    cfg.failureThreshold = 5;
+    cfg.successSampleRate = 1000;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        on_failure(cb);
+    }
+    on_success(cb);
+    REQUIRE(cb->get_failure_count() == 0);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        on_failure(cb);
+    }
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    on_failure(cb);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+// ============================================================================
+// ADMISSION CACHE TESTS
+// ============================================================================
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - cached admission observes transitions from other threads", "[circuit_breaker][admission]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("admission-cache", 2, std::chrono::seconds(10));
+
+    std::atomic<int> phase{ 0 };
+    std::atomic<bool> admittedWhileClosed{ false };
+    std::atomic<bool> rejectedWhileOpen{ false };
+
+    std::thread worker([&]()
+    {
+        // Warm this thread's cache while the breaker is closed
+        admittedWhileClosed = on_execute_function(cb) && on_execute_function(cb);
+        phase = 1;
+        while (phase != 2)
+        {
+            std::this_thread::yield();
+        }
+        rejectedWhileOpen = !on_execute_function(cb);
+    });
+
+    while (phase != 1)
+    {
+        std::this_thread::yield();
+    }
+
+    on_failure(cb);
+    on_failure(cb);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    phase = 2;
+    worker.join();
+
+    REQUIRE(admittedWhileClosed);
+    REQUIRE(rejectedWhileOpen);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - cached admission is invalidated by clear", "[circuit_breaker][admission]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("admission-clear", 2, std::chrono::seconds(10));
+    REQUIRE(on_execute_function(cb) == true);
+
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+
+    // The breaker is no longer registered, so it can no longer be admitted through the manager
+    REQUIRE(on_execute_function(cb) == false);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - outcomes reach the breaker without its registration", "[circuit_breaker][sampling]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("outcomes-direct", 5, std::chrono::seconds(10));
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+
+    record_failure(cb);
+    record_failure(cb);
+    REQUIRE(cb->get_failure_count() == 2);
+
+    record_success(cb);
+    REQUIRE(cb->get_failure_count() == 0);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - tracks the keys with the most failures", "[circuit_breaker][keys]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "keys-failures";
+    cfg.failureThreshold = 10000;
+    cfg.topKeys = 5;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    const auto fail = [](const std::string& key)
+    {
+        REQUIRE_THROWS(shield::circuit("keys-failures").with_key(key).run([]() -> int { throw std::runtime_error("down"); }));
+    };
+
+    // Any key with more than a fifth of the failures is guaranteed to be tracked
+    for (int i = 0; i < 40; ++i)
+    {
+        fail("tenant-hot");
+        fail("tenant-hot");
+        fail("tenant-warm");
+        fail("tenant-cold-" + std::to_string(i));
+    }
+    REQUIRE(shield::circuit("keys-failures").with_key("tenant-hot").run([]() { return 1; }) == 1);
+
+    const std::vector<shield::circuit_breaker::key_stats> top = cb->get_top_failure_keys();
+    REQUIRE(top.size() <= 5);
+    REQUIRE(top[0].key == "tenant-hot");
+    REQUIRE(top[0].value >= 80);
+    REQUIRE(top[0].value - top[0].error <= 80);
+    REQUIRE(std::any_of(top.begin(), top.end(), [](const shield::circuit_breaker::key_stats& stats) { return stats.key == "tenant-warm"; }));
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - tracks the keys with the most latency", "[circuit_breaker][keys]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "keys-latency";
+    cfg.topKeys = 2;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    shield::detail::circuit_breaker_manager& mgr = shield::detail::circuit_breaker_manager::get_instance();
+    for (int i = 0; i < 10; ++i)
+    {
+        mgr.on_success(cb, std::chrono::milliseconds(5), "shard-slow");
+        mgr.on_success(cb, std::chrono::microseconds(100), "shard-fast");
+    }
+    mgr.on_success(cb, std::chrono::milliseconds(5)); // Unkeyed calls are not tracked
+
+    const std::vector<shield::circuit_breaker::key_stats> top = cb->get_top_latency_keys();
+    REQUIRE(top.size() == 2);
+    REQUIRE(top[0].key == "shard-slow");
+    REQUIRE(top[0].value == 50000);
+    REQUIRE(top[1].key == "shard-fast");
+    REQUIRE(top[1].value == 1000);
+    REQUIRE(cb->get_top_failure_keys().empty());
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - key tracking is off by default", "[circuit_breaker][keys]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("keys-off", 100, std::chrono::seconds(10));
+    REQUIRE_THROWS(shield::circuit("keys-off").with_key("tenant").run([]() -> int { throw std::runtime_error("down"); }));
+
+    REQUIRE(cb->get_top_failure_keys().empty());
+    REQUIRE(cb->get_top_latency_keys().empty());
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - permits are completed from other threads", "[circuit_breaker][permit]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("permit-threads", 2, std::chrono::milliseconds(50));
+
+    shield::circuit_breaker::permit first = cb->try_acquire();
+    shield::circuit_breaker::permit second = cb->try_acquire();
+    REQUIRE(first);
+    REQUIRE(second);
+
+    std::thread([permit = std::move(first)]() mutable { permit.failure(std::runtime_error("timed out")); }).join();
+    REQUIRE(cb->get_failure_count() == 1);
+    second.failure();
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+
+    // Refused while open, and completing a refused permit records nothing
+    shield::circuit_breaker::permit refused = cb->try_acquire();
+    REQUIRE_FALSE(refused);
+    refused.failure();
+    REQUIRE(cb->get_failure_count() == 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    shield::circuit_breaker::permit trial = cb->try_acquire();
+    REQUIRE(trial);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::half_open);
+    trial.success(std::chrono::milliseconds(3));
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - a permit completes once", "[circuit_breaker][permit]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("permit-once", 1, std::chrono::seconds(10));
+
+    shield::circuit_breaker::permit permit = cb->try_acquire();
+    permit.success();
+    REQUIRE_FALSE(permit);
+    permit.failure();
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    // Dropped without an outcome, as for a cancelled call
+    {
+        shield::circuit_breaker::permit cancelled = cb->try_acquire();
+        REQUIRE(cancelled);
+    }
+    REQUIRE(cb->get_failure_count() == 0);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    // Moved-from permits are empty, and a permit outlives the breaker's registration
+    shield::circuit_breaker::permit moved = cb->try_acquire();
+    shield::circuit_breaker::permit target = std::move(moved);
+    REQUIRE_FALSE(moved);
+    shield::detail::circuit_breaker_manager::get_instance().clear();
+    target.failure();
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - batched failures trip once past the threshold", "[circuit_breaker][batch]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("batch-threshold", 5, std::chrono::milliseconds(50));
+
+    cb->record_outcomes(100, 3);
+    REQUIRE(cb->get_failure_count() == 3);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    // The successes come first, so they cannot hide the failures that follow them
+    cb->record_outcomes(100, 4);
+    REQUIRE(cb->get_failure_count() == 4);
+    cb->record_outcomes(0, 1);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    REQUIRE(on_execute_function(cb));
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::half_open);
+
+    // Any failure in a half-open batch re-opens the breaker
+    cb->record_outcomes(10, 1);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    REQUIRE(on_execute_function(cb));
+    cb->record_outcomes(10, 0);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+    REQUIRE(cb->get_failure_count() == 0);
+}
+
+TEST_CASE_METHOD(circuit_breaker_test_fixture, "Circuit breaker - batched slow calls trip the latency threshold", "[circuit_breaker][batch][latency]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "batch-latency";
+    cfg.latencyThreshold = std::chrono::milliseconds(100);
+    cfg.windowDuration = std::chrono::milliseconds(200);
+    cfg.minimumCalls = 20;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    // One slow call in two hundred is below the 99th percentile
+    const shield::circuit_breaker::latency_summary latency{ std::chrono::milliseconds(5), std::chrono::milliseconds(400) };
+    cb->record_outcomes(200, 0, 1, latency);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    cb->record_outcomes(1, 0, 0, latency);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::closed);
+
+    cb->record_outcomes(200, 0, 20, latency);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    cb->record_outcomes(1, 0, 0, latency);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+}
+
+TEST_CASE("Heavy hitters - keeps a dominant key through churn and bounds the error", "[circuit_breaker][keys]")
+{
+    shield::detail::heavy_hitters hitters(8);
+    for (int i = 0; i < 1000; ++i)
+    {
+        hitters.record("heavy", 1);
+        hitters.record("churn-" + std::to_string(i), 1);
+    }
+
+    const std::vector<shield::detail::heavy_hitters::entry> top = hitters.top();
+    REQUIRE(top.size() <= 8);
+    REQUIRE(top[0].key == "heavy");
+    REQUIRE(top[0].count >= 1000);
+    REQUIRE(top[0].count - top[0].error <= 1000);
+
+    // Keys longer than the limit are reported truncated
+    shield::detail::heavy_hitters truncated(1);
+    truncated.record(std::string(100, 'k'), 3);
+    REQUIRE(truncated.top().at(0).key == std::string(shield::detail::heavy_hitters::maxKeyLength, 'k'));
+    REQUIRE(truncated.top().at(0).count == 3);
+}
@@ -0,0 +1,105 @@
+#include <shield/all.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+struct clock_test_fixture
+{
+public:
+    clock_test_fixture()
+        : previousSource(shield::monotonic_clock::get_source())
+    {
+    }
+
+    ~clock_test_fixture()
+    {
+        shield::monotonic_clock::set_source(previousSource);
+        shield::detail::circuit_breaker_manager::get_instance().clear();
+    }
+
+private:
+    shield::monotonic_clock::source previousSource;
+};
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - default source is monotonic and advances", "[clock]")
+{
+    const shield::monotonic_clock::time_point first = shield::monotonic_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const shield::monotonic_clock::time_point second = shield::monotonic_clock::now();
+
+    REQUIRE(second > first);
+    REQUIRE(second - first >= std::chrono::milliseconds(10));
+}
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - precise source tracks the steady clock", "[clock]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::precise);
+
+    const shield::monotonic_clock::time_point steady = shield::monotonic_clock::from_steady(std::chrono::steady_clock::now());
+    const shield::monotonic_clock::time_point now = shield::monotonic_clock::now();
+
+    REQUIRE(now >= steady);
+    REQUIRE(now - steady < std::chrono::milliseconds(10));
+}
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - ticker source advances in the background", "[clock]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::ticker);
+    REQUIRE(shield::monotonic_clock::get_source() == shield::monotonic_clock::source::ticker);
+
+    const shield::monotonic_clock::time_point first = shield::monotonic_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    const shield::monotonic_clock::time_point second = shield::monotonic_clock::now();
+
+    REQUIRE(second - first >= std::chrono::milliseconds(10));
+}
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - manual source only moves when advanced", "[clock]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+
+    const shield::monotonic_clock::time_point frozen = shield::monotonic_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    REQUIRE(shield::monotonic_clock::now() == frozen);
+
+    shield::monotonic_clock::advance(std::chrono::seconds(3));
+    REQUIRE(shield::monotonic_clock::now() - frozen == std::chrono::seconds(3));
+
+    shield::monotonic_clock::set_time(frozen);
+    REQUIRE(shield::monotonic_clock::now() == frozen);
+}
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - circuit breaker timeout follows the shield clock", "[clock][circuit_breaker]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("clock-driven", 1, std::chrono::seconds(30));
+    shield::detail::circuit_breaker_manager& mgr = shield::detail::circuit_breaker_manager::get_instance();
+
+    mgr.on_failure(cb);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+
+    shield::monotonic_clock::advance(std::chrono::seconds(29));
+    REQUIRE(mgr.on_execute_function(cb) == false);
+
+    shield::monotonic_clock::advance(std::chrono::seconds(2));
+    REQUIRE(mgr.on_execute_function(cb) == true);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::half_open);
+}
+
+TEST_CASE_METHOD(clock_test_fixture, "Clock - precise_now is exact under the coarse source", "[clock]")
+{
+    const shield::monotonic_clock::time_point before = shield::monotonic_clock::from_steady(std::chrono::steady_clock::now());
+    const shield::monotonic_clock::time_point precise = shield::monotonic_clock::precise_now();
+
+    REQUIRE(precise >= before);
+    REQUIRE(precise >= shield::monotonic_clock::now() - std::chrono::milliseconds(10));
+
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+    shield::monotonic_clock::set_time(shield::monotonic_clock::time_point(std::chrono::seconds(5)));
+    REQUIRE(shield::monotonic_clock::precise_now() == shield::monotonic_clock::time_point(std::chrono::seconds(5)));
+}
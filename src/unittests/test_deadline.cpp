@@ -0,0 +1,273 @@
+#include <shield/all.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+
+namespace
+{
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+struct deadline_test_fixture
+{
+public:
+    ~deadline_test_fixture()
+    {
+        shield::detail::circuit_breaker_manager::get_instance().clear();
+    }
+};
+
+TEST_CASE("Deadline - no context outside a scope", "[deadline]")
+{
+    REQUIRE(shield::call_context::current() == nullptr);
+    REQUIRE_FALSE(shield::call_context::expired());
+    REQUIRE_FALSE(shield::call_context::remaining().has_value());
+    REQUIRE(shield::call_context::clamp(std::chrono::seconds(5)) == std::chrono::seconds(5));
+}
+
+TEST_CASE("Deadline - nested scopes only shorten the deadline", "[deadline]")
+{
+    {
+        shield::deadline_scope outer(std::chrono::seconds(1));
+        const shield::monotonic_clock::time_point outerDeadline = *shield::call_context::current()->deadline;
+
+        {
+            shield::deadline_scope longer(std::chrono::seconds(60));
+            REQUIRE(*shield::call_context::current()->deadline == outerDeadline);
+            REQUIRE(shield::call_context::clamp(std::chrono::seconds(30)) <= std::chrono::seconds(1));
+        }
+
+        {
+            shield::deadline_scope shorter(std::chrono::milliseconds(100));
+            REQUIRE(*shield::call_context::current()->deadline < outerDeadline);
+        }
+
+        REQUIRE(*shield::call_context::current()->deadline == outerDeadline);
+    }
+
+    REQUIRE(shield::call_context::current() == nullptr);
+}
+
+TEST_CASE("Deadline - captured context follows work to another thread", "[deadline]")
+{
+    shield::deadline_scope scope(std::chrono::seconds(10));
+
+    std::optional<shield::monotonic_clock::duration> unbound;
+    std::optional<shield::monotonic_clock::duration> bound;
+    std::thread([&unbound]() { unbound = shield::call_context::remaining(); }).join();
+    std::thread(shield::deadline_scope::bind([&bound]() { bound = shield::call_context::remaining(); })).join();
+
+    REQUIRE_FALSE(unbound.has_value());
+    REQUIRE(bound.has_value());
+    REQUIRE(*bound <= std::chrono::seconds(10));
+
+    // Re-installing a captured context, as a coroutine would after resuming
+    const shield::call_context captured = shield::call_context::capture();
+    std::thread([&captured, &bound]()
+    {
+        shield::deadline_scope resumed(captured);
+        bound = shield::call_context::remaining();
+    }).join();
+    REQUIRE(bound.has_value());
+}
+
+TEST_CASE_METHOD(deadline_test_fixture, "Deadline - circuit refuses to start past the deadline", "[deadline][circuit]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("deadline-expired", 5, std::chrono::seconds(10));
+
+    shield::deadline_scope scope(shield::monotonic_clock::now() - std::chrono::milliseconds(1));
+    bool invoked = false;
+    REQUIRE_THROWS_AS(shield::circuit("deadline-expired").run([&invoked]() { invoked = true; return 1; }), shield::deadline_exceeded_exception);
+
+    REQUIRE_FALSE(invoked);
+    REQUIRE(cb->get_failure_count() == 0);
+}
+
+TEST_CASE_METHOD(deadline_test_fixture, "Deadline - inner deadline failures do not count against the outer breaker", "[deadline][circuit]")
+{
+    std::shared_ptr<shield::circuit_breaker> outer = shield::circuit_breaker::create("deadline-outer", 5, std::chrono::seconds(10));
+    shield::circuit_breaker::create("deadline-inner", 5, std::chrono::seconds(10));
+
+    shield::deadline_scope scope(std::chrono::milliseconds(20));
+    REQUIRE_THROWS_AS(shield::circuit("deadline-outer").run([]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        return shield::circuit("deadline-inner").run([]() { return 1; });
+    }), shield::deadline_exceeded_exception);
+
+    REQUIRE(outer->get_failure_count() == 0);
+}
+
+TEST_CASE_METHOD(deadline_test_fixture, "Deadline - retries stop when the backoff would pass the deadline", "[deadline][retry]")
+{
+    int attempts = 0;
+    const shield::monotonic_clock::time_point started = shield::monotonic_clock::now();
+    {
+        shield::deadline_scope scope(std::chrono::milliseconds(80));
+        REQUIRE_THROWS_AS(shield::retry_policy(10).with_fixed_backoff(std::chrono::milliseconds(50)).run([&attempts]() -> int
+        {
+            ++attempts;
+            throw std::runtime_error("down");
+        }), shield::cannot_obtain_value_exception);
+    }
+
+    REQUIRE(attempts == 2);
+    REQUIRE(shield::monotonic_clock::now() - started < std::chrono::milliseconds(80));
+}
+
+TEST_CASE("Deadline - timeouts are shortened to the deadline", "[deadline][timeout]")
+{
+    shield::deadline_scope scope(std::chrono::milliseconds(30));
+
+    std::optional<shield::monotonic_clock::duration> seenByTask;
+    REQUIRE_THROWS_AS(shield::with_timeout([&seenByTask]()
+    {
+        seenByTask = shield::call_context::remaining();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return 1;
+    }, std::chrono::seconds(5)), shield::deadline_exceeded_exception);
+
+    REQUIRE(seenByTask.has_value());
+}
+
+TEST_CASE("Deadline - memory scope keeps the enclosing deadline", "[deadline][memory]")
+{
+    REQUIRE(shield::call_context::memory_resource() == std::pmr::get_default_resource());
+
+    counting_resource resource;
+    shield::deadline_scope deadline(std::chrono::seconds(10));
+    {
+        shield::memory_scope scope(resource);
+        REQUIRE(shield::call_context::memory_resource() == &resource);
+        REQUIRE(shield::call_context::remaining().has_value());
+
+        // A nested deadline keeps the resource
+        shield::deadline_scope shorter(std::chrono::seconds(1));
+        REQUIRE(shield::call_context::memory_resource() == &resource);
+    }
+
+    REQUIRE(shield::call_context::memory_resource() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("Deadline - timeouts allocate their state from the memory scope", "[deadline][memory][timeout]")
+{
+    counting_resource resource;
+    {
+        shield::memory_scope scope(resource);
+        REQUIRE(shield::with_timeout([]() { return 3; }, std::chrono::seconds(1)) == 3);
+    }
+    REQUIRE(resource.allocations > 0);
+
+    const std::size_t before = resource.allocations;
+    REQUIRE(shield::with_timeout([]() { return 3; }, std::chrono::seconds(1)) == 3);
+    REQUIRE(resource.allocations == before);
+}
+
+TEST_CASE("Deadline - nested cancellation scopes are linked", "[deadline][cancellation]")
+{
+    REQUIRE_FALSE(shield::call_context::cancelled());
+
+    std::stop_source outer;
+    std::stop_source inner;
+    shield::deadline_scope deadline(std::chrono::seconds(10));
+    {
+        shield::cancellation_scope outerScope(outer.get_token());
+        {
+            shield::cancellation_scope innerScope(inner.get_token());
+            REQUIRE(shield::call_context::remaining().has_value());
+            REQUIRE_FALSE(shield::call_context::cancelled());
+
+            outer.request_stop();
+            REQUIRE(shield::call_context::cancelled());
+        }
+        REQUIRE(shield::call_context::cancelled());
+    }
+
+    REQUIRE_FALSE(shield::call_context::cancelled());
+    REQUIRE_FALSE(inner.stop_requested());
+}
+
+TEST_CASE_METHOD(deadline_test_fixture, "Deadline - cancellation stops retries without a fallback or a failure", "[deadline][cancellation][circuit]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("cancelled-retries", 5, std::chrono::seconds(10));
+
+    bool fellBack = false;
+    shield::fallback_policy fallback = shield::fallback_policy::with_typed_callable([&fellBack]() { fellBack = true; return 0; });
+    shield::circuit cir("cancelled-retries", shield::retry_policy(10).with_fixed_backoff(std::chrono::seconds(5)), std::nullopt, fallback);
+
+    std::stop_source cancel;
+    std::thread canceller([&cancel]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        cancel.request_stop();
+    });
+
+    int attempts = 0;
+    const shield::monotonic_clock::time_point started = shield::monotonic_clock::now();
+    {
+        shield::cancellation_scope scope(cancel.get_token());
+        REQUIRE_THROWS_AS(cir.run<std::exception>([&attempts]() -> int
+        {
+            ++attempts;
+            throw std::runtime_error("down");
+        }), shield::cancelled_exception);
+    }
+    canceller.join();
+
+    // Woken from the first backoff instead of sleeping it out
+    REQUIRE(shield::monotonic_clock::now() - started < std::chrono::seconds(2));
+    REQUIRE(attempts == 1);
+    REQUIRE_FALSE(fellBack);
+    REQUIRE(cb->get_failure_count() == 1);
+    REQUIRE(cb->get_cancellation_count() == 1);
+}
+
+TEST_CASE("Deadline - cancelled timeouts ask the task to stop", "[deadline][cancellation][timeout]")
+{
+    std::stop_source cancel;
+    shield::cancellation_scope scope(cancel.get_token());
+
+    const shield::monotonic_clock::time_point started = shield::monotonic_clock::now();
+    REQUIRE_THROWS_AS(shield::with_timeout([&cancel]()
+    {
+        cancel.request_stop();
+        while (!shield::call_context::cancelled())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return 1;
+    }, std::chrono::seconds(5)), shield::cancelled_exception);
+
+    REQUIRE(shield::monotonic_clock::now() - started < std::chrono::seconds(2));
+    REQUIRE_THROWS_AS(shield::with_timeout([]() { return 1; }, std::chrono::seconds(5)), shield::cancelled_exception);
+}
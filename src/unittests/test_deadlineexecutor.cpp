@@ -0,0 +1,249 @@
+#include <shield/all.hpp>
+
+#include <detail/pairingheap.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Occupies a single threaded executor until released, so the tasks queued behind it can be ordered
+    class gate final
+    {
+    public:
+        explicit gate(shield::deadline_executor& executor)
+        {
+            std::promise<void> started;
+            std::future<void> running = started.get_future();
+            executor.post([this, &started]() { started.set_value(); opened.get_future().wait(); });
+            running.wait();
+        }
+
+        void open() { opened.set_value(); }
+
+    private:
+        std::promise<void> opened;
+    };
+
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST_CASE("Deadline executor - runs the earliest deadline first", "[deadline_executor]")
+{
+    shield::deadline_executor executor(1);
+    gate blocked(executor);
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&mutex, &order](std::string name) { return [&mutex, &order, name]() { std::lock_guard<std::mutex> lock(mutex); order.push_back(name); }; };
+
+    std::vector<std::future<void>> done;
+    {
+        shield::deadline_scope scope(std::chrono::seconds(5));
+        done.push_back(executor.submit(record("5s")));
+    }
+    done.push_back(executor.submit(record("none")));
+    {
+        shield::deadline_scope scope(std::chrono::milliseconds(500));
+        done.push_back(executor.submit(record("500ms")));
+    }
+    {
+        shield::deadline_scope scope(std::chrono::seconds(1));
+        done.push_back(executor.submit(record("1s")));
+    }
+    done.push_back(executor.submit(record("none, later")));
+    REQUIRE(executor.get_queued_count() == 5);
+
+    blocked.open();
+    for (std::future<void>& future : done)
+    {
+        future.get();
+    }
+
+    REQUIRE(order == std::vector<std::string>{ "500ms", "1s", "5s", "none", "none, later" });
+}
+
+TEST_CASE("Deadline executor - drops work whose deadline passed in the queue", "[deadline_executor]")
+{
+    shield::deadline_executor executor(1, "deadline-executor-expired");
+    gate blocked(executor);
+
+    bool invoked = false;
+    std::future<int> late;
+    {
+        shield::deadline_scope scope(std::chrono::milliseconds(20));
+        late = executor.submit([&invoked]() { invoked = true; return 1; });
+    }
+    std::future<int> timely = executor.submit([]() { return 2; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    blocked.open();
+
+    REQUIRE_THROWS_AS(late.get(), shield::deadline_exceeded_exception);
+    REQUIRE(timely.get() == 2);
+    REQUIRE_FALSE(invoked);
+    REQUIRE(executor.get_metrics().get_snapshot().rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::expired)] == 1);
+}
+
+TEST_CASE("Deadline executor - drops work whose call was cancelled in the queue", "[deadline_executor][cancellation]")
+{
+    shield::deadline_executor executor(1);
+    gate blocked(executor);
+
+    std::stop_source cancel;
+    bool invoked = false;
+    std::future<int> abandoned;
+    {
+        shield::cancellation_scope scope(cancel.get_token());
+        abandoned = executor.submit([&invoked]() { invoked = true; return 1; });
+    }
+
+    cancel.request_stop();
+    blocked.open();
+
+    REQUIRE_THROWS_AS(abandoned.get(), shield::cancelled_exception);
+    REQUIRE_FALSE(invoked);
+    REQUIRE(executor.get_metrics().get_snapshot().rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::cancelled)] == 1);
+}
+
+TEST_CASE("Deadline executor - tasks run under the submitting call context", "[deadline_executor]")
+{
+    shield::deadline_executor executor(2);
+
+    std::future<bool> bounded;
+    {
+        shield::deadline_scope scope(std::chrono::seconds(10));
+        bounded = executor.submit([]() { return shield::call_context::remaining().has_value(); });
+    }
+    std::future<bool> unbounded = executor.submit([]() { return shield::call_context::remaining().has_value(); });
+    std::future<void> failing = executor.submit([]() { throw std::runtime_error("failed"); });
+
+    REQUIRE(bounded.get());
+    REQUIRE_FALSE(unbounded.get());
+    REQUIRE_THROWS_AS(failing.get(), std::runtime_error);
+}
+
+TEST_CASE("Deadline executor - allocates from its memory resource", "[deadline_executor][memory]")
+{
+    counting_resource resource;
+    {
+        shield::deadline_executor executor(1, std::string(), &resource);
+        REQUIRE(executor.get_memory_resource() == &resource);
+        REQUIRE(executor.submit([]() { return 4; }).get() == 4);
+    }
+
+    // The queue node and the future's shared state
+    REQUIRE(resource.allocations >= 2);
+}
+
+TEST_CASE("Deadline executor - runs with_timeout tasks", "[deadline_executor][timeout]")
+{
+    shield::deadline_executor executor(1);
+
+    const std::thread::id caller = std::this_thread::get_id();
+    REQUIRE(shield::with_timeout(executor, [caller]() { return std::this_thread::get_id() != caller; }, std::chrono::seconds(1)));
+    REQUIRE_THROWS_AS(shield::with_timeout(executor, []() -> int { throw std::runtime_error("failed"); }, std::chrono::seconds(1)), std::runtime_error);
+}
+
+TEST_CASE("Deadline executor - with_timeout gives up on the task at the timeout", "[deadline_executor][timeout][cancellation]")
+{
+    shield::deadline_executor executor(1);
+
+    // The running task is asked to stop rather than waited for
+    std::promise<void> stopped;
+    std::future<void> stoppedFuture = stopped.get_future();
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_THROWS_AS(shield::with_timeout(executor, [&stopped]()
+    {
+        while (!shield::call_context::cancelled())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stopped.set_value();
+    }, std::chrono::milliseconds(20)), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    REQUIRE(stoppedFuture.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+
+    // A task still queued at the timeout never runs
+    bool ran = false;
+    {
+        gate blocked(executor);
+        REQUIRE_THROWS_AS(shield::with_timeout(executor, [&ran]() { ran = true; }, std::chrono::milliseconds(10)), std::runtime_error);
+        blocked.open();
+    }
+    REQUIRE(shield::with_timeout(executor, []() { return 1; }, std::chrono::seconds(1)) == 1);
+    REQUIRE_FALSE(ran);
+}
+
+TEST_CASE("Deadline executor - pairing heap pops in order", "[deadline_executor][pairing_heap]")
+{
+    std::mt19937 random(42);
+    std::vector<int> values(1000);
+    std::generate(values.begin(), values.end(), [&random]() { return static_cast<int>(random() % 500); });
+
+    shield::detail::pairing_heap<int, std::less<int>> heap;
+    for (int value : values)
+    {
+        heap.push(value);
+    }
+    REQUIRE(heap.size() == values.size());
+
+    // Interleave pops and pushes, as a busy queue would
+    std::vector<int> popped;
+    for (int i = 0; i < 100; ++i)
+    {
+        popped.push_back(heap.pop());
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        heap.push(1000 + i);
+        values.push_back(1000 + i);
+    }
+    while (!heap.empty())
+    {
+        popped.push_back(heap.pop());
+    }
+
+    std::sort(values.begin(), values.end());
+    REQUIRE(popped == values);
+
+    // Left non-empty on purpose, destruction frees the remaining nodes
+    shield::detail::pairing_heap<std::string, std::less<std::string>> strings;
+    strings.push("b");
+    strings.push("a");
+    strings.push("c");
+    REQUIRE(strings.top() == "a");
+}
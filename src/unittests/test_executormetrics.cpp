@@ -0,0 +1,178 @@
+#include <shield/all.hpp>
+
+#if defined(SHIELD_WITH_PROMETHEUS)
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::uint64_t count_at_or_below(const shield::executor_metrics::histogram& histogram, std::chrono::microseconds bound)
+    {
+        const auto iter = std::find_if(histogram.begin(), histogram.end(), [bound](const auto& bucket) { return bucket.first == bound; });
+        REQUIRE(iter != histogram.end());
+        return iter->second;
+    }
+
+#if defined(SHIELD_WITH_PROMETHEUS)
+    const prometheus::MetricFamily* find_family(const std::vector<prometheus::MetricFamily>& families, const std::string& name)
+    {
+        const auto iter = std::find_if(families.begin(), families.end(), [&name](const prometheus::MetricFamily& family) { return family.name == name; });
+        return iter == families.end() ? nullptr : &*iter;
+    }
+
+    bool has_executor(const prometheus::MetricFamily& family, const std::string& name)
+    {
+        return std::any_of(family.metric.begin(), family.metric.end(), [&name](const prometheus::ClientMetric& metric)
+        {
+            return std::any_of(metric.label.begin(), metric.label.end(), [&name](const prometheus::ClientMetric::Label& label) { return label.name == "executor" && label.value == name; });
+        });
+    }
+#endif
+}
+
+TEST_CASE("Executor metrics - records queue wait and execution histograms", "[executor_metrics]")
+{
+    shield::executor_metrics metrics("metrics-histograms", 4);
+    metrics.record_start(std::chrono::microseconds(3));
+    metrics.record_start(std::chrono::milliseconds(2));
+    metrics.record_finish(std::chrono::microseconds(100));
+    metrics.record_finish(std::chrono::milliseconds(50));
+
+    const shield::executor_metrics::snapshot snapshot = metrics.get_snapshot();
+    REQUIRE(snapshot.started == 2);
+    REQUIRE(snapshot.finished == 2);
+    REQUIRE(snapshot.queueWaitTotal == std::chrono::microseconds(2003));
+    REQUIRE(snapshot.executionTotal == std::chrono::microseconds(50100));
+
+    REQUIRE(count_at_or_below(snapshot.queueWait, std::chrono::microseconds(4)) == 1);
+    REQUIRE(count_at_or_below(snapshot.queueWait, std::chrono::microseconds(1024)) == 1);
+    REQUIRE(count_at_or_below(snapshot.queueWait, std::chrono::microseconds(2048)) == 2);
+    REQUIRE(count_at_or_below(snapshot.execution, std::chrono::microseconds(128)) == 1);
+    REQUIRE(count_at_or_below(snapshot.execution, std::chrono::microseconds(65536)) == 2);
+    REQUIRE(metrics.get_capacity() == 4);
+
+    // Bounds are inclusive, as prometheus le bounds are
+    shield::executor_metrics bounds;
+    bounds.record_finish(std::chrono::microseconds(2048));
+    bounds.record_finish(std::chrono::microseconds(2048) + std::chrono::nanoseconds(1));
+    REQUIRE(count_at_or_below(bounds.get_snapshot().execution, std::chrono::microseconds(1024)) == 0);
+    REQUIRE(count_at_or_below(bounds.get_snapshot().execution, std::chrono::microseconds(2048)) == 1);
+    REQUIRE(count_at_or_below(bounds.get_snapshot().execution, std::chrono::microseconds(4096)) == 2);
+}
+
+TEST_CASE("Executor metrics - counts rejections by reason", "[executor_metrics]")
+{
+    shield::executor_metrics metrics;
+    metrics.record_rejection(shield::executor_metrics::rejection_reason::capacity);
+    metrics.record_rejection(shield::executor_metrics::rejection_reason::capacity);
+    metrics.record_rejection(shield::executor_metrics::rejection_reason::timeout);
+
+    const shield::executor_metrics::snapshot snapshot = metrics.get_snapshot();
+    REQUIRE(snapshot.rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::capacity)] == 2);
+    REQUIRE(snapshot.rejections[static_cast<std::size_t>(shield::executor_metrics::rejection_reason::timeout)] == 1);
+    REQUIRE(snapshot.started == 0);
+}
+
+TEST_CASE("Executor metrics - merges cells from many threads", "[executor_metrics]")
+{
+    shield::executor_metrics metrics;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t)
+    {
+        threads.emplace_back([&metrics]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                metrics.record_start(std::chrono::microseconds(1));
+                metrics.record_finish(std::chrono::microseconds(10));
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const shield::executor_metrics::snapshot snapshot = metrics.get_snapshot();
+    REQUIRE(snapshot.started == 16000);
+    REQUIRE(snapshot.finished == 16000);
+    REQUIRE(snapshot.executionTotal == std::chrono::microseconds(160000));
+    REQUIRE(snapshot.execution.back().second == 16000);
+}
+
+TEST_CASE("Executor metrics - utilisation between snapshots", "[executor_metrics]")
+{
+    shield::executor_metrics::snapshot from;
+    from.takenAt = shield::monotonic_clock::time_point(std::chrono::seconds(10));
+    from.executionTotal = std::chrono::seconds(5);
+
+    shield::executor_metrics::snapshot to = from;
+    to.takenAt += std::chrono::seconds(10);
+    to.executionTotal += std::chrono::seconds(20);
+
+    REQUIRE(shield::executor_metrics::utilisation(from, to, 4) == 0.5);
+    REQUIRE(shield::executor_metrics::utilisation(from, to, 1) == 1.0);
+    REQUIRE(shield::executor_metrics::utilisation(from, to, 0) == 0.0);
+    REQUIRE(shield::executor_metrics::utilisation(from, from, 4) == 0.0);
+}
+
+#if defined(SHIELD_WITH_PROMETHEUS)
+TEST_CASE("Executor metrics - prometheus export covers named executors only", "[executor_metrics]")
+{
+    std::vector<prometheus::MetricFamily> families;
+    {
+        shield::executor_metrics named("metrics-exported", 8);
+        shield::executor_metrics unnamed;
+        named.record_start(std::chrono::microseconds(10));
+        named.record_rejection(shield::executor_metrics::rejection_reason::capacity);
+
+        families = shield::executor_metrics::get_prometheus_collectable()->Collect();
+
+        const prometheus::MetricFamily* queueWait = find_family(families, "shield_executor_queue_wait_seconds");
+        REQUIRE(queueWait != nullptr);
+        REQUIRE(queueWait->type == prometheus::MetricType::Histogram);
+        REQUIRE(has_executor(*queueWait, "metrics-exported"));
+        REQUIRE_FALSE(has_executor(*queueWait, ""));
+
+        const prometheus::MetricFamily* inFlight = find_family(families, "shield_executor_in_flight");
+        REQUIRE(inFlight != nullptr);
+        REQUIRE(has_executor(*inFlight, "metrics-exported"));
+
+        const prometheus::MetricFamily* rejections = find_family(families, "shield_executor_rejections_total");
+        REQUIRE(rejections != nullptr);
+        REQUIRE(std::any_of(rejections->metric.begin(), rejections->metric.end(), [](const prometheus::ClientMetric& metric) { return metric.counter.value == 1.0; }));
+    }
+
+    // Destroyed executors drop out of the export
+    families = shield::executor_metrics::get_prometheus_collectable()->Collect();
+    REQUIRE_FALSE(has_executor(*find_family(families, "shield_executor_queue_wait_seconds"), "metrics-exported"));
+}
+#endif
+
+#if defined(SHIELD_WITH_ASIO)
+TEST_CASE("Executor metrics - timeout executor records its tasks", "[executor_metrics][timeout]")
+{
+    shield::timeout_executor executor("metrics-timeout");
+    REQUIRE(executor.execute_with_timeout([]() { return 7; }, std::chrono::seconds(1)) == 7);
+
+    // The task thread records its finish after handing over the result
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (executor.get_metrics().get_snapshot().finished == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const shield::executor_metrics::snapshot snapshot = executor.get_metrics().get_snapshot();
+    REQUIRE(snapshot.started == 1);
+    REQUIRE(snapshot.finished == 1);
+}
+#endif
@@ -2,10 +2,12 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 struct ServiceResponse
@@ -431,6 +433,11 @@ TEST_CASE("fallback_policy - to_string converts THROW to string", "[fallback_pol
     REQUIRE(shield::to_string(shield::fallback_type::THROW) == "THROW");
 }
 
+TEST_CASE("fallback_policy - to_string converts MEMOISED to string", "[fallback_policy][utility]")
+{
+    REQUIRE(shield::to_string(shield::fallback_type::MEMOISED) == "MEMOISED");
+}
+
 TEST_CASE("fallback_policy - circuit breaker integration uses fallback when circuit is open", "[fallback_policy][integration]")
 {
     shield::fallback_policy circuit_fallback = shield::fallback_policy::with_typed_callable([]()
@@ -553,4 +560,64 @@ TEST_CASE("fallback_policy - callable invoked each time", "[fallback_policy][cal
 
     REQUIRE(result3.has_value());
     REQUIRE(*result3 == 3);
-}
\ No newline at end of file
+}
+
+TEST_CASE("fallback_policy - memoised callable is computed once", "[fallback_policy][memoised]")
+{
+    std::atomic<int> counter = 0;
+    shield::fallback_policy policy = shield::fallback_policy::with_typed_memoised([&counter]() { return ++counter; }, std::chrono::hours(1));
+    REQUIRE(policy.get_type() == shield::fallback_type::MEMOISED);
+    REQUIRE(policy.stored_type() == typeid(int));
+    REQUIRE(policy.can_cast_to<int>());
+    REQUIRE_FALSE(policy.can_cast_to<std::string>());
+
+    const shield::fallback_policy copy = policy;
+    for (int i = 0; i < 100; ++i)
+    {
+        REQUIRE(policy.get_value<int>() == 1);
+        REQUIRE(copy.get_value<int>() == 1);
+    }
+    REQUIRE_FALSE(policy.get_value<std::string>().has_value());
+    REQUIRE(counter == 1);
+}
+
+TEST_CASE("fallback_policy - memoised callable is refreshed in the background", "[fallback_policy][memoised]")
+{
+    std::atomic<int> counter = 0;
+    shield::fallback_policy policy = shield::fallback_policy::with_typed_memoised([&counter]() { return ++counter; }, std::chrono::milliseconds(5));
+    REQUIRE(policy.get_value<int>() == 1);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (policy.get_value<int>() == 1 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(policy.get_value<int>() > 1);
+}
+
+TEST_CASE("fallback_policy - memoised callable keeps its value when a refresh throws", "[fallback_policy][memoised]")
+{
+    std::atomic<int> calls = 0;
+    shield::fallback_policy policy = shield::fallback_policy::with_typed_memoised([&calls]() -> std::string
+    {
+        if (++calls > 1)
+        {
+            throw std::runtime_error("snapshot unavailable");
+        }
+        return "snapshot";
+    }, std::chrono::milliseconds(5));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (calls < 3 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(calls >= 3);
+    REQUIRE(policy.get_value<std::string>() == "snapshot");
+}
+
+TEST_CASE("fallback_policy - memoised validation", "[fallback_policy][memoised][validation]")
+{
+    REQUIRE_THROWS_AS(shield::fallback_policy::with_memoised(nullptr, std::chrono::seconds(1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(shield::fallback_policy::with_typed_memoised([]() { return 1; }, std::chrono::milliseconds::zero()), std::invalid_argument);
+}
@@ -0,0 +1,269 @@
+#include <shield/all.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+struct flight_recorder_test_fixture
+{
+public:
+    ~flight_recorder_test_fixture()
+    {
+        shield::detail::circuit_breaker_manager::get_instance().clear();
+    }
+
+protected:
+    static std::size_t count_of(const std::vector<shield::flight_recorder::event>& events, shield::flight_recorder::event_type type)
+    {
+        return static_cast<std::size_t>(std::count_if(events.begin(), events.end(), [type](const shield::flight_recorder::event& e) { return e.type == type; }));
+    }
+};
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - records failures, transitions and rejections", "[flight_recorder]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("recorder-basic", 2, std::chrono::seconds(10));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        REQUIRE_THROWS(shield::circuit("recorder-basic").run([]() -> int { throw std::invalid_argument("bad"); }));
+    }
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    REQUIRE_THROWS_AS(shield::circuit("recorder-basic").run([]() { return 1; }), shield::open_circuit_exception);
+
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-basic");
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::failure) >= 2);
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::transition) == 1);
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::rejection) == 1);
+
+    const auto transition = std::find_if(events.begin(), events.end(), [](const shield::flight_recorder::event& e) { return e.type == shield::flight_recorder::event_type::transition; });
+    REQUIRE(transition->payload == ((static_cast<std::uint32_t>(shield::circuit_breaker::state::closed) << 4) | static_cast<std::uint32_t>(shield::circuit_breaker::state::open)));
+
+    // Failures carry the exception type
+    REQUIRE(events.front().type == shield::flight_recorder::event_type::failure);
+    REQUIRE(events.front().payload != 0);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - records successes and retries", "[flight_recorder]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "recorder-retry";
+    cfg.failureThreshold = 10;
+    cfg.flightRecorderSuccesses = true;
+    shield::circuit_breaker::create(cfg);
+
+    int attempts = 0;
+    const int result = shield::circuit("recorder-retry", shield::retry_policy(3).with_fixed_backoff(std::chrono::milliseconds(7))).run([&attempts]()
+    {
+        if (++attempts < 3)
+        {
+            throw std::runtime_error("transient");
+        }
+        return 5;
+    });
+    REQUIRE(result == 5);
+
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-retry");
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::retry) == 2);
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::success) == 1);
+
+    const auto retry = std::find_if(events.begin(), events.end(), [](const shield::flight_recorder::event& e) { return e.type == shield::flight_recorder::event_type::retry; });
+    REQUIRE(retry->payload == 7);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - overwrites the oldest events", "[flight_recorder]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "recorder-ring";
+    cfg.failureThreshold = 1000;
+    cfg.flightRecorderEvents = 8;
+    cfg.flightRecorderSuccesses = true;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    shield::detail::circuit_breaker_manager& mgr = shield::detail::circuit_breaker_manager::get_instance();
+    for (int i = 0; i < 20; ++i)
+    {
+        mgr.on_failure(cb);
+    }
+    mgr.on_success(cb, std::chrono::microseconds(1234));
+
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-ring");
+    REQUIRE(events.size() == 8);
+    REQUIRE(events.back().type == shield::flight_recorder::event_type::success);
+    REQUIRE(events.back().payload == 1234);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - leaves successes out by default", "[flight_recorder]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("recorder-quiet", 10, std::chrono::seconds(10));
+
+    shield::detail::circuit_breaker_manager& mgr = shield::detail::circuit_breaker_manager::get_instance();
+    mgr.on_success(cb, std::chrono::microseconds(10));
+    mgr.on_failure(cb);
+    mgr.on_success(cb, std::chrono::microseconds(10));
+
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-quiet");
+    REQUIRE(events.size() == 1);
+    REQUIRE(events.front().type == shield::flight_recorder::event_type::failure);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - merges the events of every recording thread", "[flight_recorder]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "recorder-threads";
+    cfg.failureThreshold = 1000;
+    cfg.flightRecorderEvents = 64;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cb]()
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                shield::detail::circuit_breaker_manager::get_instance().on_failure(cb);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Each thread records into its own stripe at most, and nothing is lost when they share one
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-threads");
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::failure) == 32);
+    REQUIRE(std::is_sorted(events.begin(), events.end(), [](const shield::flight_recorder::event& lhs, const shield::flight_recorder::event& rhs) { return lhs.timestamp < rhs.timestamp; }));
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - records one transition to half open for racing callers", "[flight_recorder]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("recorder-half-open", 1, std::chrono::milliseconds(50));
+    shield::detail::circuit_breaker_manager::get_instance().on_failure(cb);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Every caller sees the circuit open before any of them takes the breaker's lock
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&cb, &go]()
+        {
+            while (!go.load())
+            {
+                std::this_thread::yield();
+            }
+            shield::detail::circuit_breaker_manager::get_instance().on_execute_function(cb);
+        });
+    }
+    go.store(true);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::half_open);
+    const std::vector<shield::flight_recorder::event> events = shield::flight_recorder::get_events("recorder-half-open");
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::transition) == 2);
+    REQUIRE(count_of(events, shield::flight_recorder::event_type::rejection) == 0);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - can be disabled per breaker", "[flight_recorder]")
+{
+    shield::circuit_breaker::config cfg;
+    cfg.name = "recorder-disabled";
+    cfg.flightRecorderEvents = 0;
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create(cfg);
+
+    shield::detail::circuit_breaker_manager::get_instance().on_failure(cb);
+
+    REQUIRE(shield::flight_recorder::get_events("recorder-disabled").empty());
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - dump round trips through read_dump", "[flight_recorder]")
+{
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("recorder-dump", 1, std::chrono::seconds(10));
+    REQUIRE_THROWS(shield::circuit("recorder-dump").run([]() -> int { throw std::runtime_error("boom"); }));
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "shield-recorder-dump-test.bin";
+    REQUIRE(shield::flight_recorder::dump(path.string(), "recorder-dump"));
+    REQUIRE_FALSE(shield::flight_recorder::dump(path.string() + ".missing", "no-such-breaker"));
+
+    const std::optional<shield::flight_recorder::dump_contents> contents = shield::flight_recorder::read_dump(path.string());
+    std::filesystem::remove(path);
+
+    REQUIRE(contents.has_value());
+    REQUIRE(contents->breakers.size() == 1);
+    REQUIRE(contents->breakers.count("recorder-dump") == 1);
+
+    const std::vector<shield::flight_recorder::event>& events = contents->breakers.at("recorder-dump");
+    REQUIRE(events.front().type == shield::flight_recorder::event_type::failure);
+    REQUIRE(contents->exceptionTypes.count(events.front().payload) == 1);
+    REQUIRE(contents->exceptionTypes.at(events.front().payload).find("runtime_error") != std::string::npos);
+}
+
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - read_dump rejects an event count the file cannot hold", "[flight_recorder]")
+{
+    shield::circuit_breaker::create("recorder-corrupt", 1, std::chrono::seconds(10));
+    REQUIRE_THROWS(shield::circuit("recorder-corrupt").run([]() -> int { throw std::runtime_error("boom"); }));
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "shield-recorder-corrupt-test.bin";
+    REQUIRE(shield::flight_recorder::dump(path.string(), "recorder-corrupt"));
+
+    // Claim four billion events straight after the breaker's name and cut the file off there
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const std::size_t countAt = bytes.find("recorder-corrupt") + std::string("recorder-corrupt").size();
+    REQUIRE(countAt + 4 <= bytes.size());
+    bytes.resize(countAt);
+    bytes.append(4, '\xff');
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    REQUIRE_FALSE(shield::flight_recorder::read_dump(path.string()).has_value());
+    std::filesystem::remove(path);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE_METHOD(flight_recorder_test_fixture, "Flight recorder - dumps on signal from a background thread", "[flight_recorder]")
+{
+    shield::circuit_breaker::create("recorder-signal", 1, std::chrono::seconds(10));
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "shield-recorder-signal-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    REQUIRE(shield::flight_recorder::install_signal_handler(SIGUSR2, directory.string()));
+    std::raise(SIGUSR2);
+
+    bool dumped = false;
+    for (int i = 0; i < 100 && !dumped; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+        {
+            const std::optional<shield::flight_recorder::dump_contents> contents = shield::flight_recorder::read_dump(entry.path().string());
+            dumped = dumped || (contents.has_value() && contents->breakers.count("recorder-signal") == 1);
+        }
+    }
+
+    std::signal(SIGUSR2, SIG_DFL);
+    std::filesystem::remove_all(directory);
+    REQUIRE(dumped);
+}
+#endif
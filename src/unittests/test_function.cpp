@@ -0,0 +1,107 @@
+#include <shield/all.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace
+{
+    // Counts live instances so every stored copy can be checked for destruction
+    struct tracked
+    {
+        static inline int alive = 0;
+
+        tracked() { ++alive; }
+        tracked(const tracked&) { ++alive; }
+        tracked(tracked&&) noexcept { ++alive; }
+        ~tracked() { --alive; }
+
+        int operator()(int value) const { return value + 1; }
+    };
+}
+
+TEST_CASE("Function - typical captures are stored inline", "[function]")
+{
+    int counter = 0;
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    auto byReference = [&counter](int value) { return counter + value; };
+    auto withShared = [shared, &counter](int value) { return *shared + counter + value; };
+    auto oversized = [buffer = std::array<char, 64>{}](int value) { return buffer[0] + value; };
+
+    REQUIRE(shield::small_function<int(int)>::stores_inline<decltype(byReference)>);
+    REQUIRE(shield::small_function<int(int)>::stores_inline<decltype(withShared)>);
+    REQUIRE_FALSE(shield::small_function<int(int)>::stores_inline<decltype(oversized)>);
+    REQUIRE(shield::small_function<int(int), 64>::stores_inline<decltype(oversized)>);
+
+    // The circuit breaker's own callables must never reach the heap
+    REQUIRE(shield::retry_policy::retry_predicate::stores_inline<decltype(byReference)>);
+    REQUIRE(shield::fallback_policy::callable_type::stores_inline<decltype(withShared)>);
+}
+
+TEST_CASE("Function - copies, moves and destroys the callable", "[function]")
+{
+    {
+        shield::small_function<int(int)> original = tracked();
+        REQUIRE(tracked::alive == 1);
+
+        shield::small_function<int(int)> copy = original;
+        REQUIRE(tracked::alive == 2);
+        REQUIRE(copy(1) == 2);
+
+        shield::small_function<int(int)> moved = std::move(original);
+        REQUIRE(tracked::alive == 2);
+        REQUIRE_FALSE(original);
+        REQUIRE(moved(2) == 3);
+
+        copy = nullptr;
+        REQUIRE(tracked::alive == 1);
+    }
+    REQUIRE(tracked::alive == 0);
+
+    // The same holds for callables spilled to the heap
+    {
+        shield::small_function<int(int), 0> original = tracked();
+        shield::small_function<int(int), 0> copy = original;
+        shield::small_function<int(int), 0> moved = std::move(original);
+        REQUIRE(tracked::alive == 2);
+        REQUIRE(moved(4) == 5);
+    }
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("Function - empty functions", "[function]")
+{
+    shield::small_function<void()> empty;
+    REQUIRE_FALSE(empty);
+    REQUIRE(empty == nullptr);
+    REQUIRE_THROWS_AS(empty(), std::bad_function_call);
+
+    int (*nullPointer)(int) = nullptr;
+    REQUIRE_FALSE(shield::small_function<int(int)>(nullPointer));
+    REQUIRE_FALSE(shield::small_function<int(int)>(std::function<int(int)>()));
+}
+
+TEST_CASE("Function - unique function holds move-only callables", "[function]")
+{
+    shield::unique_function<std::string()> func = [value = std::make_unique<std::string>("moved")]() { return *value; };
+    REQUIRE(func() == "moved");
+
+    shield::unique_function<std::string()> other = std::move(func);
+    REQUIRE_FALSE(func);
+    REQUIRE(other() == "moved");
+}
+
+TEST_CASE("Function - policies copy their callables", "[function][retry]")
+{
+    int calls = 0;
+    shield::retry_policy policy(3);
+    policy.with_fixed_backoff(std::chrono::milliseconds(1));
+    policy.on_retry([&calls](const std::exception&, int, std::chrono::milliseconds) { ++calls; });
+
+    const shield::retry_policy copy = policy;
+    REQUIRE_THROWS(copy.run([]() -> int { throw std::runtime_error("down"); }));
+    REQUIRE(calls == 2);
+}
@@ -482,4 +482,23 @@ TEST_CASE("Retry policy - different return types", "[retry_policy]")
         return result{ 42 };
     });
     REQUIRE(struct_result.code == 42);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Retry policy - default policies are constant-initialised", "[retry_policy]")
+{
+    // These only compile if the constructors involved can run at compile time
+    static constinit const retry_policy constantRetry(5);
+    static constinit const fallback_policy constantFallback;
+    static_assert(default_timeout_policy.timeout == std::chrono::seconds(1));
+
+    REQUIRE(constantRetry.get_max_attempts() == 5);
+    REQUIRE(constantFallback.get_type() == fallback_type::DEFAULT);
+    REQUIRE(default_fallback_policy.get_type() == fallback_type::DEFAULT);
+
+    // Every default-constructed policy, and every copy, uses the one shared backoff
+    const retry_policy copy = default_retry_policy;
+    REQUIRE(copy.get_backoff_strategy() == default_retry_policy.get_backoff_strategy());
+    REQUIRE(constantRetry.get_backoff_strategy() == default_retry_policy.get_backoff_strategy());
+    REQUIRE(typeid(*copy.get_backoff_strategy()) == typeid(exponential_backoff));
+    REQUIRE(copy.get_backoff_strategy()->calculate_delay(1) == std::chrono::milliseconds(100));
+}
@@ -0,0 +1,220 @@
+#include <shield/all.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct stats_test_fixture
+{
+public:
+    stats_test_fixture()
+        : path(std::filesystem::temp_directory_path() / "shield-stats-test.bin")
+    {
+    }
+
+    ~stats_test_fixture()
+    {
+        shield::stats_segment::close();
+        shield::detail::circuit_breaker_manager::get_instance().clear();
+        std::filesystem::remove(path);
+    }
+
+protected:
+    static const shield::stats_segment::breaker_stats* find(const shield::stats_segment::contents& contents, const std::string& name)
+    {
+        const auto iter = std::find_if(contents.breakers.begin(), contents.breakers.end(), [&name](const shield::stats_segment::breaker_stats& stats) { return stats.name == name; });
+        return iter == contents.breakers.end() ? nullptr : &*iter;
+    }
+
+    const std::filesystem::path path;
+};
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - publishes counters and state", "[stats]")
+{
+    REQUIRE(shield::stats_segment::open(path.string()));
+    REQUIRE(shield::stats_segment::is_open());
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("stats-basic", 2, std::chrono::seconds(10));
+    for (int i = 0; i < 3; ++i)
+    {
+        REQUIRE(shield::circuit("stats-basic").run([]() { return 1; }) == 1);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        REQUIRE_THROWS(shield::circuit("stats-basic").run([]() -> int { throw std::runtime_error("down"); }));
+    }
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+    REQUIRE_THROWS_AS(shield::circuit("stats-basic").run([]() { return 1; }), shield::open_circuit_exception);
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    REQUIRE(contents->capacity == shield::stats_segment::defaultCapacity);
+
+    const shield::stats_segment::breaker_stats* stats = find(*contents, "stats-basic");
+    REQUIRE(stats != nullptr);
+    REQUIRE(stats->state == shield::circuit_breaker::state::open);
+    REQUIRE(stats->successes == 3);
+    REQUIRE(stats->failures >= 2);
+    REQUIRE(stats->rejections == 1);
+    REQUIRE(stats->transitions == 1);
+    REQUIRE(stats->lastTransitionAt != 0);
+}
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - counts retries and attaches existing breakers", "[stats]")
+{
+    shield::circuit_breaker::create("stats-retry", 10, std::chrono::seconds(10));
+    REQUIRE(shield::stats_segment::open(path.string()));
+
+    int attempts = 0;
+    shield::circuit("stats-retry", shield::retry_policy(3).with_fixed_backoff(std::chrono::milliseconds(1))).run([&attempts]()
+    {
+        if (++attempts < 3)
+        {
+            throw std::runtime_error("transient");
+        }
+        return 1;
+    });
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    const shield::stats_segment::breaker_stats* stats = find(*contents, "stats-retry");
+    REQUIRE(stats != nullptr);
+    REQUIRE(stats->retries == 2);
+    REQUIRE(stats->failures == 2);
+    REQUIRE(stats->successes == 1);
+    REQUIRE(stats->state == shield::circuit_breaker::state::closed);
+}
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - readable after close", "[stats]")
+{
+    REQUIRE(shield::stats_segment::open(path.string()));
+    shield::circuit_breaker::create("stats-closed", 10, std::chrono::seconds(10));
+    shield::circuit("stats-closed").run([]() { return 1; });
+
+    shield::stats_segment::close();
+    REQUIRE_FALSE(shield::stats_segment::is_open());
+
+    // Nothing is published once closed, but the file stays valid
+    shield::circuit("stats-closed").run([]() { return 1; });
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    const shield::stats_segment::breaker_stats* stats = find(*contents, "stats-closed");
+    REQUIRE(stats != nullptr);
+    REQUIRE(stats->successes == 1);
+}
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - stops adding breakers at capacity", "[stats]")
+{
+    REQUIRE(shield::stats_segment::open(path.string(), 2));
+    shield::circuit_breaker::create("stats-capacity-1");
+    shield::circuit_breaker::create("stats-capacity-2");
+    shield::circuit_breaker::create("stats-capacity-3");
+    shield::circuit("stats-capacity-3").run([]() { return 1; });
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    REQUIRE(contents->breakers.size() == 2);
+    REQUIRE(find(*contents, "stats-capacity-3") == nullptr);
+}
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - sums the counters of every thread", "[stats]")
+{
+    REQUIRE(shield::stats_segment::open(path.string()));
+    shield::circuit_breaker::create("stats-threads", 1000, std::chrono::seconds(10));
+
+    // More threads than lanes, so some share the atomic lane
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 40; ++t)
+    {
+        threads.emplace_back([]()
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                shield::circuit("stats-threads").run([]() { return 1; });
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    const shield::stats_segment::breaker_stats* stats = find(*contents, "stats-threads");
+    REQUIRE(stats != nullptr);
+    REQUIRE(stats->successes == 4000);
+}
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - publishes named executors", "[stats][executor_metrics]")
+{
+    REQUIRE(shield::stats_segment::open(path.string()));
+
+    shield::deadline_executor executor(1, "stats-executor");
+    shield::deadline_executor unnamed(1);
+    REQUIRE(executor.submit([]() { return 2; }).get() == 2);
+    REQUIRE(unnamed.submit([]() { return 2; }).get() == 2);
+
+    // The worker records its finish after handing over the result
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (executor.get_metrics().get_snapshot().finished == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path.string());
+    REQUIRE(contents.has_value());
+    REQUIRE(contents->executors.size() == 1);
+
+    const shield::stats_segment::executor_stats& stats = contents->executors.front();
+    REQUIRE(stats.name == "stats-executor");
+    REQUIRE(stats.capacity == 1);
+    REQUIRE(stats.started == 1);
+    REQUIRE(stats.finished == 1);
+    REQUIRE(stats.rejections == std::array<std::uint64_t, shield::executor_metrics::rejectionReasonCount>{});
+}
+
+#if defined(__linux__)
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - keeps replaced segments mapped", "[stats]")
+{
+    const auto mappings = [this]()
+    {
+        std::ifstream maps("/proc/self/maps");
+        std::size_t count = 0;
+        for (std::string line; std::getline(maps, line);)
+        {
+            count += line.find(path.filename().string()) != std::string::npos ? 1 : 0;
+        }
+        return count;
+    };
+
+    // A writer holding a slot of a replaced segment may write to it at any later point, however long it waited
+    const std::size_t before = mappings();
+    for (int i = 0; i < 3; ++i)
+    {
+        REQUIRE(shield::stats_segment::open(path.string()));
+        shield::stats_segment::close();
+    }
+    REQUIRE(mappings() == before + 3);
+}
+#endif
+
+TEST_CASE_METHOD(stats_test_fixture, "Stats segment - rejects other files", "[stats]")
+{
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a stats segment, just some text that is long enough to hold a header and then some more";
+    }
+
+    REQUIRE_FALSE(shield::stats_segment::read(path.string()).has_value());
+    REQUIRE_FALSE(shield::stats_segment::read((path.string() + ".missing")).has_value());
+}
@@ -1,3 +1,29 @@
+#include <catch2/catch_test_macros.hpp>
+#include <shield/timeoutexecutor.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE("Timeout executor - times out a slow task once its io thread is running", "[timeout][executor]")
+{
+    shield::timeout_executor executor;
+
+    // With no timer pending yet, a started io thread must keep running for the timer registered below to fire
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_THROWS_AS(executor.execute_with_timeout([]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return 42;
+    }, std::chrono::milliseconds(50)), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(400));
+
+    const std::size_t timeout = static_cast<std::size_t>(shield::executor_metrics::rejection_reason::timeout);
+    REQUIRE(executor.get_metrics().get_snapshot().rejections[timeout] == 1);
+}
+
 // #include <catch2/catch_test_macros.hpp>
 // #include <catch2/matchers/catch_matchers_exception.hpp>
 // #include <shield/all.hpp>
@@ -169,4 +195,4 @@
 //     );
 //     
 //     REQUIRE(executed);
-// }
\ No newline at end of file
+// }
@@ -0,0 +1,222 @@
+#include <shield/all.hpp>
+
+#include <detail/circuit/circuitbreakermanager.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
+namespace
+{
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+struct timer_service_test_fixture
+{
+public:
+    timer_service_test_fixture()
+        : previousSource(shield::monotonic_clock::get_source())
+    {
+    }
+
+    ~timer_service_test_fixture()
+    {
+        shield::monotonic_clock::set_source(previousSource);
+        shield::detail::circuit_breaker_manager::get_instance().clear();
+    }
+
+private:
+    shield::monotonic_clock::source previousSource;
+};
+
+#if defined(__linux__)
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - descriptor wakes the loop for due timers", "[timer_service]")
+{
+    shield::timer_service timers;
+    REQUIRE(timers.native_handle() >= 0);
+
+    std::vector<int> fired;
+    timers.schedule_after(std::chrono::milliseconds(30), [&fired]() { fired.push_back(2); });
+    timers.schedule_after(std::chrono::milliseconds(10), [&fired]() { fired.push_back(1); });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (fired.size() < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        pollfd descriptor{ timers.native_handle(), POLLIN, 0 };
+        if (::poll(&descriptor, 1, 1000) > 0)
+        {
+            timers.process_expired();
+        }
+    }
+
+    REQUIRE(fired == std::vector<int>{ 1, 2 });
+    REQUIRE(timers.size() == 0);
+    REQUIRE_FALSE(timers.next_expiry().has_value());
+
+    // Nothing left to wait for, so the descriptor stays quiet
+    pollfd descriptor{ timers.native_handle(), POLLIN, 0 };
+    REQUIRE(::poll(&descriptor, 1, 20) == 0);
+}
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - every wakeup finds a due timer", "[timer_service]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::coarse);
+    shield::timer_service timers;
+
+    // A due time already passed fires at once
+    timers.schedule_at(shield::monotonic_clock::precise_now() - std::chrono::milliseconds(1), []() {});
+    pollfd descriptor{ timers.native_handle(), POLLIN, 0 };
+    REQUIRE(::poll(&descriptor, 1, 1000) == 1);
+    REQUIRE(timers.process_expired() == 1);
+
+    // The descriptor is armed for the due time itself, so it never wakes the loop before a timer is due
+    for (int i = 1; i <= 5; ++i)
+    {
+        timers.schedule_after(std::chrono::microseconds(1500 * i), []() {});
+    }
+    while (timers.size() != 0)
+    {
+        descriptor = pollfd{ timers.native_handle(), POLLIN, 0 };
+        REQUIRE(::poll(&descriptor, 1, 1000) == 1);
+        REQUIRE(timers.process_expired() >= 1);
+    }
+}
+#endif
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - follows the manual clock", "[timer_service]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+    shield::timer_service timers;
+
+    int ticks = 0;
+    shield::timer_service::callback tick;
+    tick = [&]()
+    {
+        ++ticks;
+        timers.schedule_after(std::chrono::seconds(0), [&]() { tick(); });
+    };
+    timers.schedule_after(std::chrono::seconds(1), [&]() { tick(); });
+
+    REQUIRE(timers.process_expired() == 0);
+    shield::monotonic_clock::advance(std::chrono::seconds(1));
+    REQUIRE(timers.next_expiry() <= shield::monotonic_clock::now());
+
+    // A timer scheduled by a callback waits for the next call, even when already due
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE(ticks == 2);
+}
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - cancelled timers do not run", "[timer_service]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+    shield::timer_service timers;
+
+    bool timedOut = false;
+    const shield::timer_service::timer_id timeout = timers.schedule_after(std::chrono::milliseconds(20), [&timedOut]() { timedOut = true; });
+
+    // A response processed in the same tick as its timeout cancels it
+    timers.schedule_after(std::chrono::milliseconds(10), [&]() { REQUIRE(timers.cancel(timeout)); });
+
+    shield::monotonic_clock::advance(std::chrono::milliseconds(20));
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE_FALSE(timedOut);
+    REQUIRE_FALSE(timers.cancel(timeout));
+    REQUIRE(timers.size() == 0);
+}
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - drives retry backoff", "[timer_service][retry]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+    shield::timer_service timers;
+
+    const shield::retry_policy policy = shield::retry_policy(3).with_fixed_backoff(std::chrono::milliseconds(5));
+
+    int attempts = 0;
+    bool fellBack = false;
+    shield::timer_service::callback attempt;
+    attempt = [&]()
+    {
+        ++attempts;
+        const std::runtime_error error("unavailable");
+        if (!policy.schedule_retry(timers, error, attempts, [&]() { attempt(); }))
+        {
+            fellBack = true;
+        }
+    };
+
+    attempt();
+    REQUIRE(attempts == 1);
+    REQUIRE(timers.size() == 1);
+
+    shield::monotonic_clock::advance(std::chrono::milliseconds(4));
+    REQUIRE(timers.process_expired() == 0);
+    shield::monotonic_clock::advance(std::chrono::milliseconds(1));
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE(attempts == 2);
+
+    shield::monotonic_clock::advance(std::chrono::milliseconds(5));
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE(attempts == 3);
+    REQUIRE(fellBack);
+    REQUIRE(timers.size() == 0);
+}
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - wakes the loop when the breaker would admit a trial call", "[timer_service][circuit_breaker]")
+{
+    shield::monotonic_clock::set_source(shield::monotonic_clock::source::manual);
+    shield::timer_service timers;
+
+    std::shared_ptr<shield::circuit_breaker> cb = shield::circuit_breaker::create("timer-half-open", 1, std::chrono::milliseconds(100));
+    cb->try_acquire().failure();
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::open);
+
+    bool admitted = false;
+    cb->when_half_open(timers, [&]() { admitted = static_cast<bool>(cb->try_acquire()); });
+
+    shield::monotonic_clock::advance(std::chrono::milliseconds(100));
+    REQUIRE(timers.process_expired() == 0);
+    shield::monotonic_clock::advance(std::chrono::nanoseconds(1));
+    REQUIRE(timers.process_expired() == 1);
+    REQUIRE(admitted);
+    REQUIRE(cb->get_state() == shield::circuit_breaker::state::half_open);
+}
+
+TEST_CASE_METHOD(timer_service_test_fixture, "Timer service - allocates timers from its memory resource", "[timer_service][memory]")
+{
+    counting_resource resource;
+    shield::timer_service timers(&resource);
+
+    timers.schedule_after(std::chrono::seconds(10), []() {});
+    timers.schedule_after(std::chrono::seconds(20), []() {});
+    REQUIRE(resource.allocations == 2);
+}
@@ -0,0 +1,118 @@
+// shieldstat - prints the circuit breaker and executor stats a process publishes through shield::stats_segment
+//
+// usage: shieldstat <stats file> [refresh interval in milliseconds]
+// Without an interval the file is printed once, which also works after the publishing process has exited.
+
+#include <shield/stats.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+
+namespace
+{
+    const char* to_string(shield::circuit_breaker::state state)
+    {
+        switch (state)
+        {
+        case shield::circuit_breaker::state::closed:
+            return "CLOSED";
+        case shield::circuit_breaker::state::open:
+            return "OPEN";
+        case shield::circuit_breaker::state::half_open:
+            return "HALF_OPEN";
+        }
+        return "?";
+    }
+
+    // Timestamps in the segment are milliseconds since the unix epoch
+    std::uint64_t seconds_since(std::uint64_t millis)
+    {
+        const std::uint64_t nowMillis = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        return nowMillis > millis ? (nowMillis - millis) / 1000 : 0;
+    }
+
+    void print(const shield::stats_segment::contents& contents)
+    {
+
+        std::cout << "pid " << contents.pid << ", " << contents.breakers.size() + contents.executors.size() << "/" << contents.capacity << " slots, segment opened "
+                  << seconds_since(contents.createdAt) << "s ago\n";
+        std::cout << std::left << std::setw(32) << "name" << std::right
+                  << std::setw(10) << "state" << std::setw(8) << "fails"
+                  << std::setw(14) << "successes" << std::setw(12) << "failures" << std::setw(12) << "rejected"
+                  << std::setw(10) << "cancelled" << std::setw(10) << "retries" << std::setw(8) << "trans" << std::setw(14) << "last trans" << "\n";
+
+        for (const shield::stats_segment::breaker_stats& breaker : contents.breakers)
+        {
+            std::cout << std::left << std::setw(32) << breaker.name << std::right
+                      << std::setw(10) << to_string(breaker.state) << std::setw(8) << breaker.failureCount
+                      << std::setw(14) << breaker.successes << std::setw(12) << breaker.failures << std::setw(12) << breaker.rejections
+                      << std::setw(10) << breaker.cancellations << std::setw(10) << breaker.retries << std::setw(8) << breaker.transitions;
+            if (breaker.lastTransitionAt == 0)
+            {
+                std::cout << std::setw(14) << "-";
+            }
+            else
+            {
+                std::cout << std::setw(13) << seconds_since(breaker.lastTransitionAt) << "s";
+            }
+            std::cout << "\n";
+        }
+
+        if (contents.executors.empty())
+        {
+            std::cout << std::flush;
+            return;
+        }
+
+        std::cout << "\n" << std::left << std::setw(32) << "executor" << std::right
+                  << std::setw(10) << "capacity" << std::setw(14) << "started" << std::setw(14) << "finished" << std::setw(12) << "rejected"
+                  << std::setw(14) << "avg wait us" << std::setw(14) << "avg run us" << "\n";
+
+        for (const shield::stats_segment::executor_stats& executor : contents.executors)
+        {
+            const std::uint64_t rejected = std::accumulate(executor.rejections.begin(), executor.rejections.end(), std::uint64_t(0));
+            const auto average = [](std::chrono::nanoseconds total, std::uint64_t count) { return count == 0 ? 0 : std::chrono::duration_cast<std::chrono::microseconds>(total).count() / static_cast<long long>(count); };
+            std::cout << std::left << std::setw(32) << executor.name << std::right
+                      << std::setw(10) << executor.capacity << std::setw(14) << executor.started << std::setw(14) << executor.finished << std::setw(12) << rejected
+                      << std::setw(14) << average(executor.queueWaitTotal, executor.started) << std::setw(14) << average(executor.executionTotal, executor.finished) << "\n";
+        }
+        std::cout << std::flush;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <stats file> [refresh interval ms]\n";
+        return 2;
+    }
+
+    const std::string path = argv[1];
+    const long interval = argc == 3 ? std::strtol(argv[2], nullptr, 10) : 0;
+
+    while (true)
+    {
+        const std::optional<shield::stats_segment::contents> contents = shield::stats_segment::read(path);
+        if (!contents)
+        {
+            std::cerr << "shieldstat: '" << path << "' is not a shield stats segment (version " << shield::stats_segment::fileVersion << ")\n";
+            return 1;
+        }
+
+        print(*contents);
+        if (interval <= 0)
+        {
+            return 0;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+        std::cout << "\n";
+    }
+}